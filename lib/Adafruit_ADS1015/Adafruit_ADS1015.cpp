@@ -25,6 +25,7 @@
 #endif
 
 #include <Wire.h>
+#include <avr/sleep.h>
 
 #include "Adafruit_ADS1015.h"
 
@@ -145,6 +146,27 @@ uint16_t Adafruit_ADS1015::readADC_SingleEnded(uint8_t channel) {
   {
     return 0;
   }
+
+  startADC_SingleEnded(channel);
+
+  // Wait for the conversion to complete
+  delay(m_conversionDelay);
+
+  return collectADC_SingleEnded();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Starts a single-shot conversion on the specified channel.
+            The result can be read with collectADC_SingleEnded()
+            getConversionDelay() ms later.
+*/
+/**************************************************************************/
+void Adafruit_ADS1015::startADC_SingleEnded(uint8_t channel) {
+  if (channel > 3)
+  {
+    return;
+  }
   
   // Start with default values
   uint16_t config = ADS1015_REG_CONFIG_CQUE_NONE    | // Disable the comparator (default val)
@@ -179,15 +201,56 @@ uint16_t Adafruit_ADS1015::readADC_SingleEnded(uint8_t channel) {
 
   // Write config register to the ADC
   writeRegister(m_i2cAddress, ADS1015_REG_POINTER_CONFIG, config);
+}
 
-  // Wait for the conversion to complete
-  delay(m_conversionDelay);
-
+/**************************************************************************/
+/*!
+    @brief  Reads the result of the conversion started with
+            startADC_SingleEnded()
+*/
+/**************************************************************************/
+uint16_t Adafruit_ADS1015::collectADC_SingleEnded() {
   // Read the conversion results
   // Shift 12-bit results right 4 bits for the ADS1015
   return readRegister(m_i2cAddress, ADS1015_REG_POINTER_CONVERT) >> m_bitShift;  
 }
 
+/**************************************************************************/
+/*!
+    @brief  Same as readADC_SingleEnded() but puts the MCU in idle
+            mode instead of busy waiting in delay()
+*/
+/**************************************************************************/
+uint16_t Adafruit_ADS1015::readADC_SingleEnded_Idle(uint8_t channel) {
+  unsigned long start = millis();
+
+  if (channel > 3)
+  {
+    return 0;
+  }
+
+  startADC_SingleEnded(channel);
+
+  // Timer0 wakes us up every ms
+  while (millis() - start < m_conversionDelay)
+  {
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    sleep_mode();
+  }
+
+  return collectADC_SingleEnded();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gets the time a single conversion takes in ms
+*/
+/**************************************************************************/
+uint8_t Adafruit_ADS1015::getConversionDelay()
+{
+  return m_conversionDelay;
+}
+
 /**************************************************************************/
 /*! 
     @brief  Reads the conversion results, measuring the voltage
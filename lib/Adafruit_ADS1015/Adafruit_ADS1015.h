@@ -15,6 +15,7 @@
 
     v1.0  - First release
     v1.1  - Added ADS1115 support - W. Earl
+    v1.2  - Split single ended reads into start/collect
 */
 /**************************************************************************/
 #ifndef ADS1X15_H
@@ -132,6 +133,10 @@ protected:
   Adafruit_ADS1015(uint8_t i2cAddress = ADS1015_ADDRESS);
   void begin(void);
   uint16_t  readADC_SingleEnded(uint8_t channel);
+  void      startADC_SingleEnded(uint8_t channel);
+  uint16_t  collectADC_SingleEnded(void);
+  uint16_t  readADC_SingleEnded_Idle(uint8_t channel);
+  uint8_t   getConversionDelay(void);
   int16_t   readADC_Differential_0_1(void);
   int16_t   readADC_Differential_2_3(void);
   void      startComparator_SingleEnded(uint8_t channel, int16_t threshold);
@@ -70,8 +70,16 @@ int32_t Adafruit_BMP085::computeB5(int32_t UT) {
 }
 
 uint16_t Adafruit_BMP085::readRawTemperature(void) {
+  delay(startTemperature());
+  return collectRawTemperature();
+}
+
+uint8_t Adafruit_BMP085::startTemperature(void) {
   write8(BMP085_CONTROL, BMP085_READTEMPCMD);
-  delay(5);
+  return BMP085_TEMPDELAY;
+}
+
+uint16_t Adafruit_BMP085::collectRawTemperature(void) {
 #if BMP085_DEBUG == 1
   Serial.print("Raw temp: "); Serial.println(read16(BMP085_TEMPDATA));
 #endif
@@ -79,18 +87,25 @@ uint16_t Adafruit_BMP085::readRawTemperature(void) {
 }
 
 uint32_t Adafruit_BMP085::readRawPressure(void) {
-  uint32_t raw;
+  delay(startPressure());
+  return collectRawPressure();
+}
 
+uint8_t Adafruit_BMP085::startPressure(void) {
   write8(BMP085_CONTROL, BMP085_READPRESSURECMD + (oversampling << 6));
 
   if (oversampling == BMP085_ULTRALOWPOWER) 
-    delay(5);
+    return 5;
   else if (oversampling == BMP085_STANDARD) 
-    delay(8);
+    return 8;
   else if (oversampling == BMP085_HIGHRES) 
-    delay(14);
+    return 14;
   else 
-    delay(26);
+    return 26;
+}
+
+uint32_t Adafruit_BMP085::collectRawPressure(void) {
+  uint32_t raw;
 
   raw = read16(BMP085_PRESSUREDATA);
 
@@ -114,12 +129,18 @@ uint32_t Adafruit_BMP085::readRawPressure(void) {
 
 
 int32_t Adafruit_BMP085::readPressure(void) {
-  int32_t UT, UP, B3, B5, B6, X1, X2, X3, p;
-  uint32_t B4, B7;
+  int32_t UT, UP;
 
   UT = readRawTemperature();
   UP = readRawPressure();
 
+  return computePressure(UT, UP);
+}
+
+int32_t Adafruit_BMP085::computePressure(int32_t UT, int32_t UP) {
+  int32_t B3, B5, B6, X1, X2, X3, p;
+  uint32_t B4, B7;
+
 #if BMP085_DEBUG == 1
   // use datasheet numbers!
   UT = 27898;
@@ -200,10 +221,20 @@ int32_t Adafruit_BMP085::readSealevelPressure(float altitude_meters) {
 }
 
 float Adafruit_BMP085::readTemperature(void) {
-  int32_t UT, B5;     // following ds convention
+  return computeTemperature(readRawTemperature());
+}
+
+float Adafruit_BMP085::computeTemperature(int32_t UT) {
   float temp;
 
-  UT = readRawTemperature();
+  temp = computeTemperatureDeci(UT);
+  temp /= 10;
+  
+  return temp;
+}
+
+int16_t Adafruit_BMP085::computeTemperatureDeci(int32_t UT) {
+  int32_t X1, X2;     // following ds convention
 
 #if BMP085_DEBUG == 1
   // use datasheet numbers!
@@ -214,11 +245,12 @@ float Adafruit_BMP085::readTemperature(void) {
   md = 2868;
 #endif
 
-  B5 = computeB5(UT);
-  temp = (B5+8) >> 4;
-  temp /= 10;
-  
-  return temp;
+  // Same as computeB5 with X1 in 1/16 units. The X2 division
+  // multiplies the truncation of X1 by up to 15 at the hot end,
+  // which is more than one LSB in 0.1 C.
+  X1 = (UT - (int32_t)ac6) * ((int32_t)ac5) >> 11;
+  X2 = (int32_t)mc * 32768 / (X1 + (int32_t)md * 16);
+  return (X1 + X2 * 16 + 128) >> 8;
 }
 
 float Adafruit_BMP085::readAltitude(float sealevelPressure) {
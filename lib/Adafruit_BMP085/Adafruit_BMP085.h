@@ -51,6 +51,8 @@
 #define BMP085_READTEMPCMD          0x2E
 #define BMP085_READPRESSURECMD            0x34
 
+#define BMP085_TEMPDELAY         5  // Temperature conversion time (ms)
+
 
 class Adafruit_BMP085 {
  public:
@@ -62,6 +64,16 @@ class Adafruit_BMP085 {
   float readAltitude(float sealevelPressure = 101325); // std atmosphere
   uint16_t readRawTemperature(void);
   uint32_t readRawPressure(void);
+
+  // Split conversions: start*() returns the conversion time in ms,
+  // collect*() reads the result once that time has passed
+  uint8_t startTemperature(void);
+  uint16_t collectRawTemperature(void);
+  uint8_t startPressure(void);
+  uint32_t collectRawPressure(void);
+  float computeTemperature(int32_t UT);
+  int16_t computeTemperatureDeci(int32_t UT);  // 0.1 C, no float math
+  int32_t computePressure(int32_t UT, int32_t UP);
   
  private:
   int32_t computeB5(int32_t UT);
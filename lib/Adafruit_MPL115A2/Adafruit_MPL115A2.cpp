@@ -18,6 +18,11 @@
     v1.0 - First release
     v1.1 - Rick Sellens added casts to make bit shifts work below 22.6C
          - get both P and T with a single call to getPT
+    v1.2 - split getPT into startConversion/readPT so the conversion
+           can overlap with other work
+         - readPTFixed does the compensation in integer math. The
+           coefficients are kept raw so the float library is only
+           linked when the float API is used
 */
 /**************************************************************************/
 #if ARDUINO >= 100
@@ -56,39 +61,22 @@ static void i2cwrite(uint8_t x) {
 */
 /**************************************************************************/
 void Adafruit_MPL115A2::readCoefficients() {
-  int16_t a0coeff;
-  int16_t b1coeff;
-  int16_t b2coeff;
-  int16_t c12coeff;
-
   Wire.beginTransmission(MPL115A2_ADDRESS);
   i2cwrite((uint8_t)MPL115A2_REGISTER_A0_COEFF_MSB);
   Wire.endTransmission();
 
   Wire.requestFrom(MPL115A2_ADDRESS, 8);
-  a0coeff = (( (uint16_t) i2cread() << 8) | i2cread());
-  b1coeff = (( (uint16_t) i2cread() << 8) | i2cread());
-  b2coeff = (( (uint16_t) i2cread() << 8) | i2cread());
-  c12coeff = (( (uint16_t) (i2cread() << 8) | i2cread())) >> 2;
+  // a0 has 3 fractional bits, b1 13, b2 14 and c12 22
+  _mpl115a2_a0 = (( (uint16_t) i2cread() << 8) | i2cread());
+  _mpl115a2_b1 = (( (uint16_t) i2cread() << 8) | i2cread());
+  _mpl115a2_b2 = (( (uint16_t) i2cread() << 8) | i2cread());
+  _mpl115a2_c12 = (( (uint16_t) (i2cread() << 8) | i2cread())) >> 2;
 
   /*  
-  Serial.print("A0 = "); Serial.println(a0coeff, HEX);
-  Serial.print("B1 = "); Serial.println(b1coeff, HEX);
-  Serial.print("B2 = "); Serial.println(b2coeff, HEX);
-  Serial.print("C12 = "); Serial.println(c12coeff, HEX);
-  */
-
-  _mpl115a2_a0 = (float)a0coeff / 8;
-  _mpl115a2_b1 = (float)b1coeff / 8192;
-  _mpl115a2_b2 = (float)b2coeff / 16384;
-  _mpl115a2_c12 = (float)c12coeff;
-  _mpl115a2_c12 /= 4194304.0;
-
-  /*
-  Serial.print("a0 = "); Serial.println(_mpl115a2_a0);
-  Serial.print("b1 = "); Serial.println(_mpl115a2_b1);
-  Serial.print("b2 = "); Serial.println(_mpl115a2_b2);
-  Serial.print("c12 = "); Serial.println(_mpl115a2_c12);
+  Serial.print("A0 = "); Serial.println(_mpl115a2_a0, HEX);
+  Serial.print("B1 = "); Serial.println(_mpl115a2_b1, HEX);
+  Serial.print("B2 = "); Serial.println(_mpl115a2_b2, HEX);
+  Serial.print("C12 = "); Serial.println(_mpl115a2_c12, HEX);
   */
 }
 
@@ -98,10 +86,10 @@ void Adafruit_MPL115A2::readCoefficients() {
 */
 /**************************************************************************/
 Adafruit_MPL115A2::Adafruit_MPL115A2() {
-  _mpl115a2_a0 = 0.0F;
-  _mpl115a2_b1 = 0.0F;
-  _mpl115a2_b2 = 0.0F;
-  _mpl115a2_c12 = 0.0F;
+  _mpl115a2_a0 = 0;
+  _mpl115a2_b1 = 0;
+  _mpl115a2_b2 = 0;
+  _mpl115a2_c12 = 0;
 }
 
 /**************************************************************************/
@@ -146,28 +134,47 @@ float Adafruit_MPL115A2::getTemperature() {
 */
 /**************************************************************************/
 void Adafruit_MPL115A2::getPT(float *P, float *T) {
-  uint16_t 	pressure, temp;
-  float     pressureComp;
+  startConversion();
 
-  // Get raw pressure and temperature settings
+  // Wait a bit for the conversion to complete (3ms max)
+  delay(MPL115A2_CONVERSIONDELAY);
+
+  readPT(P, T);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Starts a pressure and temperature conversion. The result can
+            be read with readPT() MPL115A2_CONVERSIONDELAY ms later.
+*/
+/**************************************************************************/
+void Adafruit_MPL115A2::startConversion() {
   Wire.beginTransmission(MPL115A2_ADDRESS);
   i2cwrite((uint8_t)MPL115A2_REGISTER_STARTCONVERSION);
   i2cwrite((uint8_t)0x00);
   Wire.endTransmission();
+}
 
-  // Wait a bit for the conversion to complete (3ms max)
-  delay(5);
+/**************************************************************************/
+/*!
+    @brief  Reads the result of the last conversion started with
+            startConversion()
+*/
+/**************************************************************************/
+void Adafruit_MPL115A2::readPT(float *P, float *T) {
+  uint16_t 	pressure, temp;
+  float     pressureComp;
+  float     a0, b1, b2, c12;
 
-  Wire.beginTransmission(MPL115A2_ADDRESS);
-  i2cwrite((uint8_t)MPL115A2_REGISTER_PRESSURE_MSB);  // Register
-  Wire.endTransmission();
+  readRaw(&pressure, &temp);
 
-  Wire.requestFrom(MPL115A2_ADDRESS, 4);
-  pressure = (( (uint16_t) i2cread() << 8) | i2cread()) >> 6;
-  temp = (( (uint16_t) i2cread() << 8) | i2cread()) >> 6;
+  a0 = (float)_mpl115a2_a0 / 8;
+  b1 = (float)_mpl115a2_b1 / 8192;
+  b2 = (float)_mpl115a2_b2 / 16384;
+  c12 = (float)_mpl115a2_c12 / 4194304.0;
 
   // See datasheet p.6 for evaluation sequence
-  pressureComp = _mpl115a2_a0 + (_mpl115a2_b1 + _mpl115a2_c12 * temp ) * pressure + _mpl115a2_b2 * temp;
+  pressureComp = a0 + (b1 + c12 * temp ) * pressure + b2 * temp;
 
   // Return pressure and temperature as floating point values
   *P = ((65.0F / 1023.0F) * pressureComp) + 50.0F;        // kPa
@@ -175,5 +182,49 @@ void Adafruit_MPL115A2::getPT(float *P, float *T) {
   
 }
 
+/**************************************************************************/
+/*!
+    @brief  Same as readPT() in integer math. P is in Pa, T in 1/100 C.
+            Both are within one LSB of the float results.
+*/
+/**************************************************************************/
+void Adafruit_MPL115A2::readPTFixed(uint32_t *P, int16_t *T) {
+  uint16_t  pressure, temp;
+  int32_t   a1, pressureComp;
+  int32_t   dt;
+
+  readRaw(&pressure, &temp);
+
+  // Same evaluation sequence as readPT with every term scaled to 18
+  // fractional bits, enough that the truncation of c12 * temp stays
+  // well below one count after the multiplication by the pressure.
+  // The sum fits in 32 bits for |a1| < 4 (the datasheet has -2.4).
+  a1 = (int32_t)_mpl115a2_b1 * 32 + (((int32_t)_mpl115a2_c12 * temp) >> 4);
+  pressureComp = (int32_t)_mpl115a2_a0 * 32768 + a1 * pressure
+               + (int32_t)_mpl115a2_b2 * temp * 16;
+
+  // 65 kPa span over 1023 counts: 65000 / 1023 = 63 + 551 / 1023.
+  // Drop to 10 fractional bits first so the products fit in 32 bits.
+  pressureComp >>= 8;
+  *P = 50000 + ((pressureComp * 63 + pressureComp * 551 / 1023 + 512) >> 10);
+
+  // -5.35 counts per C, 25 C at 498 counts. Round to nearest.
+  dt = ((int32_t)498 - temp) * 10000;
+  *T = 2500 + (dt + (dt < 0 ? -267 : 267)) / 535;
+}
 
+/**************************************************************************/
+/*!
+    @brief  Reads the raw 10 bit pressure and temperature of the last
+            conversion
+*/
+/**************************************************************************/
+void Adafruit_MPL115A2::readRaw(uint16_t *pressure, uint16_t *temp) {
+  Wire.beginTransmission(MPL115A2_ADDRESS);
+  i2cwrite((uint8_t)MPL115A2_REGISTER_PRESSURE_MSB);  // Register
+  Wire.endTransmission();
 
+  Wire.requestFrom(MPL115A2_ADDRESS, 4);
+  *pressure = (( (uint16_t) i2cread() << 8) | i2cread()) >> 6;
+  *temp = (( (uint16_t) i2cread() << 8) | i2cread()) >> 6;
+}
@@ -53,6 +53,12 @@
     #define MPL115A2_REGISTER_STARTCONVERSION      (0x12)
 /*=========================================================================*/
 
+/*=========================================================================
+    CONVERSION DELAY (in mS)
+    -----------------------------------------------------------------------*/
+    #define MPL115A2_CONVERSIONDELAY               (5)
+/*=========================================================================*/
+
 class Adafruit_MPL115A2{
  public:
   Adafruit_MPL115A2();
@@ -60,14 +66,19 @@ class Adafruit_MPL115A2{
   float getPressure(void);
   float getTemperature(void);
   void getPT(float *P, float *T);
+  void startConversion(void);
+  void readPT(float *P, float *T);
+  void readPTFixed(uint32_t *P, int16_t *T);
 
  private:
-  float _mpl115a2_a0;
-  float _mpl115a2_b1;
-  float _mpl115a2_b2;
-  float _mpl115a2_c12;
+  // Raw factory coefficients, see readCoefficients()
+  int16_t _mpl115a2_a0;
+  int16_t _mpl115a2_b1;
+  int16_t _mpl115a2_b2;
+  int16_t _mpl115a2_c12;
 
   void readCoefficients(void);
+  void readRaw(uint16_t *pressure, uint16_t *temp);
 };
 
 #endif
@@ -13,7 +13,7 @@ void HIH613x::measurementRequest() const
 byte HIH613x::dataFetch()
 {
     byte read_byte, status_data;
-    uint16_t temperature_data, humidity_data;
+    uint16_t temperature_raw, humidity_raw;
 
     // request 4 bytes
     Wire.requestFrom(address, (uint8_t) 4);
@@ -27,19 +27,19 @@ byte HIH613x::dataFetch()
     // byte 1
     read_byte = Wire.read();
     status_data = read_byte >> 6;
-    humidity_data = (read_byte & 0x3f) << 8;
+    humidity_raw = (read_byte & 0x3f) << 8;
 
     // byte 2
     read_byte = Wire.read();
-    humidity_data += read_byte;
+    humidity_raw += read_byte;
 
     // byte 3
     read_byte = Wire.read();
-    temperature_data = read_byte << 6;
+    temperature_raw = read_byte << 6;
 
     // byte 4
     read_byte = Wire.read();
-    temperature_data += read_byte >> 2;
+    temperature_raw += read_byte >> 2;
 
     // end transmission
     Wire.endTransmission();
@@ -49,9 +49,9 @@ byte HIH613x::dataFetch()
         return status_data;
     }
 
-    // convert
-    humidity = humidity_data / (pow(2, 14) - 1) * 100;
-    temperature = temperature_data / (pow(2, 14) - 1) * 165 - 40;
+    // keep the raw counts, converted on demand
+    humidity_data = humidity_raw;
+    temperature_data = temperature_raw;
 
     return 0;
 }
@@ -59,7 +59,6 @@ byte HIH613x::dataFetch()
 byte HIH613x::update()
 {
     measurementRequest();
-    delay(50);
+    delay(HIH613X_MEASUREMENT_MS);
     return dataFetch();
-    
 }
@@ -4,6 +4,9 @@
 #include <Arduino.h>
 #include <Wire.h>
 
+// Time between measurementRequest() and dataFetch()
+#define HIH613X_MEASUREMENT_MS 50
+
 class HIH613x
 {
 public:
@@ -13,8 +16,12 @@ public:
 
     // simple api
     byte update();
-    float getHumidity() const { return humidity; }
-    float getTemperature() const { return temperature; }
+    float getHumidity() const { return humidity_data / 16383.0 * 100; }
+    float getTemperature() const { return temperature_data / 16383.0 * 165 - 40; }
+
+    // raw 14 bit counts, 0 to 16383 maps to 0-100 %RH and -40-125 C
+    uint16_t getHumidityRaw() const { return humidity_data; }
+    uint16_t getTemperatureRaw() const { return temperature_data; }
 
     // advanced api
     void measurementRequest() const;
@@ -23,8 +30,8 @@ public:
 private:
     // core
     byte address;
-    float temperature = 1;
-    float humidity = 1;
+    uint16_t temperature_data = 4071;     // 1 C
+    uint16_t humidity_data = 164;         // 1 %RH
 };
 
 #endif
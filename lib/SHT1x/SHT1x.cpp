@@ -106,13 +106,43 @@ float SHT1x::readHumidity()
   return (_correctedHumidity);
 }
 
+/**
+ * Same as readHumidity() in integer math, in 1/100 %RH
+ */
+int SHT1x::readHumidityCenti()
+{
+  int _val;                    // Raw humidity value returned from sensor
+  int _tval;                   // Raw temperature value
+  long _humidity;              // Humidity in 1/10000 %RH
+
+  // Command to send to the SHT1x to request humidity
+  int _gHumidCmd = 0b00000101;
+
+  // Fetch the value from the sensor
+  sendCommandSHT(_gHumidCmd, _dataPin, _clockPin);
+  waitForResultSHT(_dataPin);
+  _val = getData16SHT(_dataPin, _clockPin);
+  skipCrcSHT(_dataPin, _clockPin);
+
+  // Linear conversion, C1..C3 scaled by 10000
+  _humidity = -40000L + 405L * _val - (28L * _val * _val) / 1000;
+
+  // Temperature correction (T - 25) * (T1 + T2 * val), with
+  // T - 25 = (tval - 6500) / 100 and T1 + T2 * val = (125 + val) / 12500
+  _tval = readTemperatureRaw();
+  _humidity += ((long)_tval - 6500) * (125 + _val) / 125;
+
+  // Round to nearest, truncating would add up to 1/100 %RH
+  return ((_humidity + (_humidity < 0 ? -50 : 50)) / 100);
+}
+
 
 /* ================  Private methods ================ */
 
 /**
  * Reads the current raw temperature value
  */
-float SHT1x::readTemperatureRaw()
+int SHT1x::readTemperatureRaw()
 {
   int _val;
 
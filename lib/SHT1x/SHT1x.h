@@ -23,13 +23,14 @@ class SHT1x
   public:
     SHT1x(int dataPin, int clockPin);
     float readHumidity();
+    int readHumidityCenti();
     float readTemperatureC();
     float readTemperatureF();
   private:
     int _dataPin;
     int _clockPin;
     int _numBits;
-    float readTemperatureRaw();
+    int readTemperatureRaw();
     int shiftIn(int _dataPin, int _clockPin, int _numBits);
     void sendCommandSHT(int _command, int _dataPin, int _clockPin);
     void waitForResultSHT(int _dataPin);
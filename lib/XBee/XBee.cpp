@@ -1545,8 +1545,8 @@ void XBee::send(XBeeRequest &request) {
 	// send checksum
 	sendByte(checksum, true);
 
-	// send packet (Note: prior to Arduino 1.0 this flushed the incoming buffer, which of course was not so great)
-	flush();
+	// Don't flush() here: with a buffered transport send() returns as
+	// soon as the frame is queued. Call flush() to wait for it to go out.
 }
 
 void XBee::sendByte(uint8_t b, bool escape) {
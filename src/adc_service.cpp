@@ -0,0 +1,206 @@
+/*******************************
+ *
+ * File: adc_service.cpp
+ *
+ * Round robin, oversampling ADC service. See adc_service.h.
+ *
+ ******************************/
+
+#include "adc_service.h"
+#include "soft_uart.h"
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+
+struct adc_chan{
+    uint8_t mux;
+    uint8_t bits;
+    uint8_t count;          // Conversions summed so far
+    uint16_t sum;
+    uint16_t result;
+    uint8_t fresh;          // result is from a pass not read yet
+};
+
+static struct adc_chan chans[_ADC_SERVICE_CHANNELS_];
+static uint8_t chan_count = 0;
+
+// Channels left in the current pass, one bit each
+static volatile uint8_t pass_mask = 0;
+static volatile uint8_t cur = 0;
+static uint8_t discard = 0;
+
+/******************************
+ *
+ * Name:        adc_service_next
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Switch to the next channel of the pass and start
+ *              its first conversion, or end the pass. The first
+ *              conversion after a mux change is thrown away, the
+ *              sample and hold needs time to settle on high
+ *              impedance dividers.
+ *
+ ******************************/
+static void adc_service_next(void){
+    uint8_t i;
+
+    for(i = 0; i < chan_count; i++){
+        if(pass_mask & _BV(i)){
+            cur = i;
+            ADMUX = _BV(REFS0) | chans[i].mux;
+            discard = 1;
+            ADCSRA |= _BV(ADSC);
+            return;
+        }
+    }
+}
+
+ISR(ADC_vect){
+    uint16_t v = ADC;
+    struct adc_chan* c = &chans[cur];
+
+    if(discard){
+        discard = 0;
+    }
+    else{
+        c->sum += v;
+        if(++c->count >= (1 << (2 * c->bits))){
+            c->result = c->sum >> c->bits;
+            c->fresh = 1;
+            c->sum = 0;
+            c->count = 0;
+            pass_mask &= ~_BV(cur);
+            adc_service_next();
+            return;
+        }
+    }
+    ADCSRA |= _BV(ADSC);
+}
+
+/******************************
+ *
+ * Name:        adc_service_open
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Enable the ADC with its interrupt. The ADC clock
+ *              is kept at or below 125 kHz, as analogRead() does.
+ *
+ ******************************/
+void adc_service_open(void){
+    uint8_t presc = F_CPU > 8000000UL ? 7 : 6;      // /128 or /64
+
+    chan_count = 0;
+    pass_mask = 0;
+    ADCSRA = _BV(ADEN) | _BV(ADIE) | presc;
+}
+
+/******************************
+ *
+ * Name:        adc_service_add
+ * Returns:     Channel handle for adc_service_read()
+ * Parameter:   Analog pin (A0-A7), extra bits (0 to 3)
+ * Description: Register a channel. Called from the device
+ *              open functions.
+ *
+ ******************************/
+uint8_t adc_service_add(uint8_t pin, uint8_t bits){
+    struct adc_chan* c;
+
+    if(chan_count >= _ADC_SERVICE_CHANNELS_){
+        Serial.println(F("ADC service: too many channels"));
+        return _ADC_SERVICE_CHANNELS_ - 1;
+    }
+
+    c = &chans[chan_count];
+    c->mux = (pin >= A0 ? pin - A0 : pin) & 0x07;
+    c->bits = bits > _ADC_SERVICE_BITS_MAX_ ? _ADC_SERVICE_BITS_MAX_ : bits;
+    c->count = 0;
+    c->sum = 0;
+    c->result = 0;
+    c->fresh = 0;
+    return chan_count++;
+}
+
+/******************************
+ *
+ * Name:        adc_service_start
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Start a pass over every channel in the
+ *              background. Called from sample_start(), so the
+ *              results are ready by the time they are read.
+ *
+ ******************************/
+void adc_service_start(void){
+    uint8_t old_sreg = SREG;
+
+    cli();
+    if(pass_mask == 0 && chan_count){
+        pass_mask = (1 << chan_count) - 1;
+        adc_service_next();
+    }
+    SREG = old_sreg;
+}
+
+/******************************
+ *
+ * Name:        adc_service_busy
+ * Returns:     1 while a pass is running
+ * Parameter:   Nothing
+ * Description: The scheduler stays out of power-down, which
+ *              turns the ADC off
+ *
+ ******************************/
+uint8_t adc_service_busy(void){
+    return pass_mask != 0;
+}
+
+/******************************
+ *
+ * Name:        adc_service_read
+ * Returns:     Oversampled result, 0 to _ADC_SERVICE_MAX_(bits)
+ * Parameter:   Channel handle
+ * Description: Take the result of the last pass. If there is
+ *              none, convert the channel on its own. Sleeps
+ *              until the result is in.
+ *
+ ******************************/
+uint16_t adc_service_read(uint8_t ch){
+    struct adc_chan* c = &chans[ch];
+    uint16_t v;
+
+    cli();
+    if(!c->fresh && !(pass_mask & _BV(ch))){
+        if(pass_mask == 0){
+            pass_mask = _BV(ch);
+            adc_service_next();
+        }
+        else{
+            pass_mask |= _BV(ch);
+        }
+    }
+
+    // Check and sleep with interrupts off, so the last
+    // conversion can't complete in between and leave us
+    // asleep with nothing left to wake us up
+    while(!c->fresh){
+        #ifdef ADC_NR_SLEEP
+        if(!xbee_serial.busy()){
+            set_sleep_mode(SLEEP_MODE_ADC);
+        }
+        else{
+            set_sleep_mode(SLEEP_MODE_IDLE);
+        }
+        #else
+        set_sleep_mode(SLEEP_MODE_IDLE);
+        #endif
+        sleep_enable();
+        sei();
+        sleep_cpu();
+        sleep_disable();
+        cli();
+    }
+    v = c->result;
+    c->fresh = 0;
+    sei();
+    return v;
+}
@@ -0,0 +1,46 @@
+/*******************************
+ *
+ * File: adc_service.h
+ *
+ * Interrupt driven ADC acquisition for the on-chip analog
+ * inputs (battery, panel, Apple's pyranometer).
+ *
+ * Each device registers its pin once with the number of extra
+ * bits it wants. A conversion pass then runs from the
+ * ADC-complete interrupt, going round robin over the channels:
+ * each channel is converted 4^bits times, summed and shifted
+ * right by bits (oversampling and decimation), so 2 extra bits
+ * give a 12 bit result and 3 give 13 bits. The MCU sleeps while
+ * a pass runs instead of busy-waiting in analogRead().
+ *
+ * Oversampling only adds resolution if the input carries about
+ * 1 LSB of noise, which the divider and sensor noise provide.
+ *
+ * With -DADC_NR_SLEEP the MCU waits in ADC noise reduction sleep,
+ * which stops the CPU and I/O clocks during each conversion. That
+ * also stops Timer0 (millis() falls behind by one conversion time
+ * per conversion) and Timer2, so it's only used while the XBee
+ * soft UART is quiet; otherwise the wait is in idle sleep.
+ *
+ * analogRead() must not be used while the service is open, the
+ * interrupt would take its conversion.
+ *
+ ******************************/
+
+#include <Arduino.h>
+
+#define _ADC_SERVICE_CHANNELS_ 4
+#define _ADC_SERVICE_BITS_MAX_ 3        // 64 conversions fit the 16 bit sum
+
+// Full scale of a result with the given extra bits
+#define _ADC_SERVICE_MAX_(bits) (1023UL << (bits))
+
+#ifndef ADC_SERVICE_H
+#define ADC_SERVICE_H
+
+void adc_service_open(void);
+uint8_t adc_service_add(uint8_t pin, uint8_t bits);
+void adc_service_start(void);
+uint8_t adc_service_busy(void);
+uint16_t adc_service_read(uint8_t ch);
+#endif
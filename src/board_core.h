@@ -0,0 +1,965 @@
+/*******************************
+ *
+ * File: board_core.h
+ *
+ * Generation independent board logic (sampling, transmitting,
+ * heartbeats, command mode and scheduling).
+ *
+ * The board is a template parameterized by a per-generation traits
+ * type (see g*_board.h in each gen_ directory) that provides the
+ * packet type, pins and device list. Every call into the traits is
+ * resolved at compile time, so there is no table of function
+ * pointers in RAM and calls into the devices can be inlined.
+ *
+ * A traits type provides:
+ *
+ *   packet_t                   Data packet, starts with
+ *                              SCHEMA_PACKET_HEADER (schema.h)
+ *   packet_len                 Size of packet_t on the wire
+ *   schema                     Data packet schema number
+ *   pin_sen_en                 Sensor enable pin (-1 if none)
+ *   sen_warmup_ms              Longest warm-up of the devices on
+ *                              the sensor rail, see sen_power.h
+ *   sen_power_up()             Re-initialize the devices that lose
+ *                              state when the rail is cut
+ *   print_build_opts()         Print the generation name
+ *   open()                     Open every device on the board
+ *   post()                     Run the self test of every device
+ *   sample_start()             Start the conversion of every device
+ *                              that can convert in the background
+ *   sample(packet_t*)          Collect every device into the packet
+ *   write(frame_writer*, p)    Serialize a packet for transmission
+ *   write_delta(w, p, prev)    Serialize the fields of p after the
+ *                              header as deltas from prev
+ *   irr_read()                 Irradiance reading, sampled in the
+ *                              background
+ *   irr_summary(p, stats)      Fill the packet with the irradiance
+ *                              statistics of the report window
+ *   changed(a, b)              1 if a field of b moved past its
+ *                              deadband from a
+ *   naddr_read()               Node address
+ *   batt_read()                Battery voltage in mV
+ *   xbee_write(data, len)      Transmit a payload, tracking its
+ *                              delivery where the board supports it
+ *   xbee_write_once(data, len) Transmit a payload that is not
+ *                              worth resending (heartbeats)
+ *   xbee_poll()                Handle XBee frames and radio sleep
+ *   xbee_awake()               1 while a frame from the radio is
+ *                              expected (TX status, reply)
+ *   print_cmd_help()           Print generation specific commands
+ *   run_cmd(line)              Run a generation specific console
+ *                              command, 1 if the line was one
+ *
+ ******************************/
+
+#include <Arduino.h>
+#include <XBee.h>
+#include "sample_ring.h"
+#include "frame_writer.h"
+#include "schema.h"
+#include "power_policy.h"
+#include "window_stats.h"
+#include "clock.h"
+#include "time_sync.h"
+#include "tx_slot.h"
+#include "sen_power.h"
+#include "console.h"
+#include "log.h"
+#include "prof.h"
+#include "ram_watch.h"
+
+#ifndef BOARD_CORE_H
+#define BOARD_CORE_H
+
+// Board task periods. The sample period is set by the power
+// policy, see power_policy.h.
+#define _BOARD_HEARTBEAT_PERIOD_MS_ 3000
+#define _BOARD_HEARTBEAT_MAX_MS_ (1000UL*69*5)
+
+// After the boot burst a heartbeat still goes out this often, so
+// the RAM high-water marks reach the fleet data for the life of
+// the box. It is sent with delivery tracking.
+#define _BOARD_HEARTBEAT_SLOW_MS_ (1000UL*60*60*3)
+#define _BOARD_IRR_PERIOD_MS_ 1000
+
+// Longest time without a reported sample. Samples that stay
+// inside every deadband of Traits::changed() are dropped until
+// then. Override with -DREPORT_MAX_S=N, 0 reports every sample.
+#ifdef REPORT_MAX_S
+#define _BOARD_REPORT_MAX_MS_ (1000UL*REPORT_MAX_S)
+#else
+#define _BOARD_REPORT_MAX_MS_ (1000UL*60*5)
+#endif
+
+// Number of samples collected before they are transmitted.
+// Override with -DBATCH_SAMPLES=N in platformio.ini.
+#ifdef BATCH_SAMPLES
+#define _BOARD_BATCH_SAMPLES_ BATCH_SAMPLES
+#else
+#define _BOARD_BATCH_SAMPLES_ 1
+#endif
+
+// Largest payload of a single frame. The XBee library can frame
+// MAX_FRAME_DATA_SIZE bytes including the ZB TX request header, but
+// ZigBee firmware limits unicast payloads further (ATNP, 84 bytes).
+#define _BOARD_FRAME_PAYLOAD_MAX_ (MAX_FRAME_DATA_SIZE - ZB_TX_API_LENGTH - 2)
+#define _BOARD_FRAME_PAYLOAD_NP_ 84
+#define _BOARD_FRAME_PAYLOAD_ \
+    (_BOARD_FRAME_PAYLOAD_MAX_ < _BOARD_FRAME_PAYLOAD_NP_ ? \
+     _BOARD_FRAME_PAYLOAD_MAX_ : _BOARD_FRAME_PAYLOAD_NP_)
+
+// Batches of samples go out delta coded (see SCHEMA_DELTA in
+// schema.h) unless built with -DNO_DELTA_BATCH, then every sample
+// is written in full
+#ifndef NO_DELTA_BATCH
+#define _BOARD_DELTA_BATCH_
+#endif
+
+// Delta batch header: schema | _SCHEMA_DELTA_, sample count,
+// epoch of the first sample, drift varint (3 bytes at most)
+#define _BOARD_DELTA_HEADER_LEN_ 12
+
+// Heartbeat, see SCHEMA_HEARTBEAT_FIELDS in schema.h
+#define _BOARD_HEARTBEAT_LEN_ SCHEMA_LEN(SCHEMA_HEARTBEAT_FIELDS)
+
+struct board_heartbeat{
+    SCHEMA_STRUCT(SCHEMA_HEARTBEAT_FIELDS)
+};
+
+static inline void board_heartbeat_write(struct frame_writer* w, const struct board_heartbeat* p){
+    SCHEMA_WRITE(SCHEMA_HEARTBEAT_FIELDS)
+}
+
+/******************************
+ *
+ * Name:        board_moved
+ * Returns:     1 if the values differ by more than the deadband
+ * Parameter:   Last reported value, new value, deadband
+ * Description: Used by Traits::changed()
+ *
+ ******************************/
+static inline uint8_t board_moved(long reported, long value, long band){
+    return value - reported > band || reported - value > band;
+}
+
+template <class Traits>
+struct board_core{
+    typedef typename Traits::packet_t packet_t;
+
+    static_assert(Traits::packet_len + _BOARD_DELTA_HEADER_LEN_ <= _BOARD_FRAME_PAYLOAD_,
+                  "packet does not fit in one XBee frame");
+
+    // AVR structs have no padding, so a wire length that differs
+    // from the struct size means write() is missing a field
+    static_assert(alignof(uint32_t) > 1 || sizeof(packet_t) == Traits::packet_len,
+                  "packet_len does not match packet_t");
+
+    static_assert(_PROF_DIAG_LEN_ <= _BOARD_FRAME_PAYLOAD_,
+                  "profiling stats do not fit in one XBee frame");
+
+    void init(void);
+    void print_build_opts(void);
+    void setup(void);
+    void post(void);
+
+    void sample(void);
+    int ready_report(void);
+    int ready_sample(void);
+
+    void irr_sample(void);
+    int ready_irr_sample(void);
+
+    void tx(void);
+    uint8_t write_batch(struct frame_writer* w);
+    int ready_tx(void);
+
+    void run_cmd(void);
+    int ready_run_cmd(void);
+
+    // Console commands every board has
+    static const struct console_cmd cmds[];
+    static void cmd_help(void);
+    static void cmd_post(void);
+    static void cmd_test(void);
+    static void cmd_ram(void);
+    #ifdef PROFILE
+    static void cmd_prof(void);
+    static void cmd_prof_clear(void);
+    #endif
+
+    void heartbeat_tx(void);
+    int ready_heartbeat_tx(void);
+    static uint8_t heartbeat_burst(uint64_t now);
+
+    void xbee_poll(void);
+
+    // Sensor rail, switched on ahead of sensor reads
+    int ready_sen_warmup(void);
+    void sen_warmup(void);
+    void sen_wait(void);
+    void sen_rest(void);
+    uint8_t sen_due(void);
+
+    unsigned long next_event_ms(void);
+
+    // Task times on the monotonic clock, see clock.h. Samples and
+    // heartbeats are due at the node's uplink slot, see tx_slot.h.
+    uint64_t next_sample_ms;
+    uint64_t next_heartbeat_ms;
+    uint64_t prev_irr_ms;
+    int sample_count;
+    uint16_t node_addr;
+    packet_t data_packet;
+    sample_ring<packet_t, _BOARD_BATCH_SAMPLES_> samples;
+    struct power_policy policy;
+
+    // Last sample queued for transmission, for report-by-exception
+    packet_t reported;
+    uint64_t reported_ms;
+    uint8_t reported_valid;
+
+    // Irradiance statistics of the current report window
+    struct window_stats irr;
+
+    // Payload of the frame being sent. Kept here rather than on
+    // the stack of tx()/heartbeat_tx(); XBee::send streams it
+    // straight to the serial port.
+    uint8_t frame[_BOARD_FRAME_PAYLOAD_];
+};
+
+/******************************
+ *
+ * Name:        board_core::init
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Initialize board state and the data packet
+ *
+ ******************************/
+template <class Traits>
+void board_core<Traits>::init(void){
+    // State Variables
+    sample_count = 0;
+    node_addr = 0;
+    prev_irr_ms = 0;
+
+    samples.clear();
+    irr.clear();
+    policy.init(_BOARD_BATCH_SAMPLES_);
+    reported_ms = 0;
+    reported_valid = 0;
+
+    // Initialize the packet
+    memset(&data_packet, 0, sizeof(data_packet));
+    data_packet.schema = Traits::schema;
+    data_packet.node_addr = Traits::naddr_read();
+
+    // Boxes that power up together share a boot time, so the
+    // first sample and heartbeat already go out in the slot
+    tx_slot_open(data_packet.node_addr);
+    next_sample_ms = clock_ms() + tx_slot_offset(policy.sample_ms);
+    next_heartbeat_ms = clock_ms() + tx_slot_offset(_BOARD_HEARTBEAT_PERIOD_MS_);
+}
+
+/******************************
+ *
+ * Name:        board_core::print_build_opts
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Initialize baudrate and print board generation
+ *
+ ******************************/
+template <class Traits>
+void board_core<Traits>::print_build_opts(void){
+    Serial.begin(9600);
+    Serial.println(F("Board Opts"));
+    Traits::print_build_opts();
+}
+
+/******************************
+ *
+ * Name:        board_core::setup
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Power the sensor rail, initialize sensors,
+ *              obtain node address from eeprom
+ *
+ ******************************/
+template <class Traits>
+void board_core<Traits>::setup(void){
+    Serial.begin(9600);
+    Serial.println(F("Board Setup Start"));
+
+    // The devices are opened on a warm rail; post() cuts it
+    sen_power_open(Traits::pin_sen_en);
+    sen_power_on();
+    sen_power_wait(Traits::sen_warmup_ms);
+
+    // Open Devices
+    Traits::open();
+
+    // load the address from the hardware
+    node_addr = Traits::naddr_read();
+    data_packet.node_addr = node_addr;
+
+    delay(100);
+    Serial.println(F("Board Setup Done"));
+}
+
+/******************************
+ *
+ * Name:        board_core::post
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Power on self test when board initially starts
+ *              and poll each sensor. Also used to check
+ *              sensor values on serial monitor.
+ *
+ ******************************/
+template <class Traits>
+void board_core<Traits>::post(void){
+    sen_wait();
+    Serial.println(F("POST Begin"));
+    Traits::post();
+    Serial.println(F("POST End"));
+    sen_rest();
+}
+
+/******************************
+ *
+ * Name:        board_core::sample
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Sample each sensor into the data packet and
+ *              queue it in the sample ring for the next tx()
+ *              unless nothing changed
+ *
+ ******************************/
+template <class Traits>
+void board_core<Traits>::sample(void){
+    PROF_SCOPE(PROF_SAMPLE);
+
+    print_log(_LOG_INFO_, LOG_SAMPLE_START, 0);
+
+    // The rail normally went on ahead of time, see
+    // ready_sen_warmup(), so this doesn't wait
+    sen_wait();
+
+    // Start every slow conversion up front so they run in
+    // parallel, then collect them. The devices idle the MCU
+    // while waiting for a result instead of calling delay().
+    uint64_t now = clock_ms();
+
+    data_packet.uptime_ms = now;
+    data_packet.overflow_num = now >> 32;
+    Traits::sample_start();
+    Traits::sample(&data_packet);
+    if(irr.n == 0){
+        irr.add(Traits::irr_read());
+    }
+    Traits::irr_summary(&data_packet, &irr);
+
+    // A sample that is not sent keeps the irradiance window
+    // open, so the next one covers the whole time since the
+    // last report
+    if(ready_report()){
+        samples.push(data_packet);
+        reported = data_packet;
+        reported_ms = now;
+        reported_valid = 1;
+        irr.clear();
+    }
+    else{
+        print_log(_LOG_INFO_, LOG_SAMPLE_UNCHANGED, 0);
+    }
+
+    // Pick the next sample period from the fresh voltages. Stub
+    // readings aren't voltages, stub builds keep the normal period.
+    #ifndef SEN_STUB
+    policy.update(data_packet.batt_mv, data_packet.panel_mv, _BOARD_BATCH_SAMPLES_);
+    #endif
+    next_sample_ms = tx_slot_next(now, policy.sample_ms);
+    sen_rest();
+
+    print_log(_LOG_INFO_, LOG_SAMPLE_END, samples.count);
+    sample_count = samples.count;
+}
+
+/******************************
+ *
+ * Name:        board_core::ready_report
+ * Returns:     Integer indicating if the new sample is sent
+ * Parameter:   Nothing
+ * Description: Report-by-exception. A sample is sent if a field
+ *              moved past its deadband since the last sample
+ *              sent, or if nothing was sent for
+ *              _BOARD_REPORT_MAX_MS_.
+ *
+ ******************************/
+template <class Traits>
+int board_core<Traits>::ready_report(void){
+    if(!reported_valid){
+        return 1;
+    }
+    if(clock_ms() - reported_ms >= _BOARD_REPORT_MAX_MS_){
+        return 1;
+    }
+    return Traits::changed(&reported, &data_packet);
+}
+
+/******************************
+ *
+ * Name:        board_core::ready_tx
+ * Returns:     Integer indicating if ready to transmit
+ * Parameter:   Nothing
+ * Description: Checks if enough samples have been collected
+ *              to transmit a batch. The power policy sets the
+ *              batch size.
+ *
+ ******************************/
+template <class Traits>
+int board_core<Traits>::ready_tx(void){
+    return samples.count >= policy.tx_samples;
+}
+
+/******************************
+ *
+ * Name:        board_core::ready_sample
+ * Returns:     Integer indicating if ready to sample
+ * Parameter:   Nothing
+ * Description: Returns a "1" once the next sample is due,
+ *              one sample period of the power policy (30
+ *              seconds normally) after the last one, in the
+ *              node's uplink slot. sample() sets the next time.
+ *              This implementation is used instead of a delay
+ *              since delay will block all other operations.
+ *
+ ******************************/
+template <class Traits>
+int board_core<Traits>::ready_sample(void){
+    return clock_ms() >= next_sample_ms;
+}
+
+/******************************
+ *
+ * Name:        board_core::irr_sample
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Add an irradiance reading to the window
+ *              statistics
+ *
+ ******************************/
+template <class Traits>
+void board_core<Traits>::irr_sample(void){
+    PROF_SCOPE(PROF_IRR_SAMPLE);
+
+    sen_wait();
+    irr.add(Traits::irr_read());
+    sen_rest();
+}
+
+/******************************
+ *
+ * Name:        board_core::ready_irr_sample
+ * Returns:     Integer indicating if an irradiance reading is due
+ * Parameter:   Nothing
+ * Description: Samples the irradiance every
+ *              _BOARD_IRR_PERIOD_MS_, much faster than the
+ *              other sensors, so cloud transients show up in
+ *              the window statistics
+ *
+ ******************************/
+template <class Traits>
+int board_core<Traits>::ready_irr_sample(void){
+    const uint64_t now = clock_ms();
+
+    if(now - prev_irr_ms >= _BOARD_IRR_PERIOD_MS_){
+        prev_irr_ms = now;
+        return 1;
+    }
+    return 0;
+}
+
+/******************************
+ *
+ * Name:        board_core::ready_run_cmd
+ * Returns:     Non-zero if there is console input
+ * Parameter:   Nothing
+ * Description: Input from the serial port or a command line
+ *              received over the radio
+ *
+ ******************************/
+template <class Traits>
+int board_core<Traits>::ready_run_cmd(void){
+    return console_ready();
+}
+
+/******************************
+ *
+ * Name:        board_core::run_cmd
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Run the next complete console line, if any.
+ *              Never waits for input, so the other tasks keep
+ *              running while the console is in use.
+ *
+ ******************************/
+template <class Traits>
+void board_core<Traits>::run_cmd(void){
+    char* line = console_read();
+
+    if(line == NULL){
+        return;
+    }
+
+    PROF_SCOPE(PROF_CMD);
+
+    log_flush(1);
+    Serial.print(F("GOT A CMD: "));
+    Serial.println(line);
+
+    // Many commands read a sensor
+    sen_wait();
+    if(!console_run(line, cmds, sizeof(cmds) / sizeof(cmds[0])) &&
+       !Traits::run_cmd(line)){
+        Serial.println(F("Unknown command, ? for help"));
+    }
+    sen_rest();
+}
+
+/******************************
+ *
+ * Name:        board_core::cmd_help
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Console command, list every command
+ *
+ ******************************/
+template <class Traits>
+void board_core<Traits>::cmd_help(void){
+    console_help(cmds, sizeof(cmds) / sizeof(cmds[0]));
+    Traits::print_cmd_help();
+}
+
+/******************************
+ *
+ * Name:        board_core::cmd_post
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Console command, run the self test
+ *
+ ******************************/
+template <class Traits>
+void board_core<Traits>::cmd_post(void){
+    Serial.println(F("Running POST"));
+    Serial.println(F("POST Begin"));
+    Traits::post();
+    Serial.println(F("POST End"));
+}
+
+template <class Traits>
+void board_core<Traits>::cmd_test(void){
+    Serial.println(F("CMD Mode cmd"));
+}
+
+/******************************
+ *
+ * Name:        board_core::cmd_ram
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Console command, print the SRAM high-water marks
+ *
+ ******************************/
+template <class Traits>
+void board_core<Traits>::cmd_ram(void){
+    Serial.print(F("Stack max: "));
+    Serial.println(ram_watch_stack_max());
+    Serial.print(F("Free min: "));
+    Serial.println(ram_watch_free_min());
+}
+
+#ifdef PROFILE
+/******************************
+ *
+ * Name:        board_core::cmd_prof
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Console command, print the profiling stats
+ *
+ ******************************/
+template <class Traits>
+void board_core<Traits>::cmd_prof(void){
+    prof_dump();
+}
+
+template <class Traits>
+void board_core<Traits>::cmd_prof_clear(void){
+    prof_clear();
+    Serial.println(F("Profile cleared"));
+}
+#endif
+
+static const char board_cmd_help[] PROGMEM = "? - List commands";
+static const char board_cmd_post[] PROGMEM = "P - Run Power On Self-Test";
+static const char board_cmd_test[] PROGMEM = "T - Console test";
+static const char board_cmd_ram[] PROGMEM = "M - SRAM high-water marks";
+#ifdef PROFILE
+static const char board_cmd_prof[] PROGMEM = "D - Dump profiling stats";
+static const char board_cmd_prof_clear[] PROGMEM = "DC - Clear profiling stats";
+#endif
+
+template <class Traits>
+const struct console_cmd board_core<Traits>::cmds[] PROGMEM = {
+    {board_cmd_help, board_core<Traits>::cmd_help},
+    {board_cmd_post, board_core<Traits>::cmd_post},
+    {board_cmd_test, board_core<Traits>::cmd_test},
+    {board_cmd_ram, board_core<Traits>::cmd_ram},
+    #ifdef PROFILE
+    {board_cmd_prof, board_core<Traits>::cmd_prof},
+    {board_cmd_prof_clear, board_core<Traits>::cmd_prof_clear},
+    #endif
+};
+
+/******************************
+ *
+ * Name:        board_core::ready_heartbeat_tx
+ * Returns:     Integer indicating if ready to transmit
+ * Parameter:   Nothing
+ * Description: Waits 3 seconds between heartbeats, in the
+ *              node's uplink slot, and returns a "1" after 3
+ *              seconds. After the first
+ *              5 minutes the wait is _BOARD_HEARTBEAT_SLOW_MS_
+ *              unless HB_FOREVER is defined.
+ *
+ ******************************/
+template <class Traits>
+int board_core<Traits>::ready_heartbeat_tx(void){
+    const uint64_t now = clock_ms();
+
+    if( now >= next_heartbeat_ms){
+        next_heartbeat_ms = tx_slot_next(now, heartbeat_burst(now) ?
+                                         _BOARD_HEARTBEAT_PERIOD_MS_ :
+                                         _BOARD_HEARTBEAT_SLOW_MS_);
+        return 1;
+    }
+    return 0;
+}
+
+/******************************
+ *
+ * Name:        board_core::heartbeat_burst
+ * Returns:     1 during the burst of heartbeats after boot
+ * Parameter:   Time on the monotonic clock
+ * Description: The first 5 minutes, or always with HB_FOREVER.
+ *              On the 64-bit clock, so the burst doesn't come
+ *              back each time millis() wraps.
+ *
+ ******************************/
+template <class Traits>
+uint8_t board_core<Traits>::heartbeat_burst(uint64_t now){
+    #ifdef HB_FOREVER
+    return 1;
+    #else
+    return now < _BOARD_HEARTBEAT_MAX_MS_;
+    #endif
+}
+
+/******************************
+ *
+ * Name:        board_core::heartbeat_tx
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Transmits heartbeat packet
+ *
+ ******************************/
+template <class Traits>
+void board_core<Traits>::heartbeat_tx(void){
+    PROF_SCOPE(PROF_HEARTBEAT);
+    struct board_heartbeat hb;
+    struct frame_writer w;
+    const uint64_t now = clock_ms();
+
+    print_log(_LOG_DEBUG_, LOG_HEARTBEAT_START, 0);
+
+    hb.schema = _SCHEMA_HEARTBEAT_;
+    hb.node_addr = Traits::naddr_read();
+    hb.uptime_ms = now;
+    hb.overflow_num = now >> 32;
+    hb.batt_mv = Traits::batt_read();
+    hb.sample_s = policy.sample_ms / 1000;
+    hb.tx_samples = policy.tx_samples;
+    hb.stack_max = ram_watch_stack_max();
+    hb.free_min = ram_watch_free_min();
+
+    w.begin(frame, sizeof(frame));
+    board_heartbeat_write(&w, &hb);
+    // The slow heartbeats carry the RAM marks for the fleet data,
+    // those are worth storing while the link is down
+    if(heartbeat_burst(now)){
+        Traits::xbee_write_once(frame, w.len);
+    }
+    else{
+        Traits::xbee_write(frame, w.len);
+    }
+
+    // Profiling stats ride along with the heartbeat, which is
+    // already best effort and rate limited
+    #if defined(PROFILE) && defined(PROFILE_DIAG)
+    w.begin(frame, sizeof(frame));
+    prof_write(&w, Traits::naddr_read());
+    Traits::xbee_write_once(frame, w.len);
+    #endif
+
+    print_log(_LOG_DEBUG_, LOG_HEARTBEAT_END, 0);
+}
+
+/******************************
+ *
+ * Name:        board_core::tx
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Transmits the queued sensor packets, packing as
+ *              many as fit into each XBee frame
+ *
+ ******************************/
+template <class Traits>
+void board_core<Traits>::tx(void){
+    PROF_SCOPE(PROF_TX);
+    struct frame_writer w;
+
+    print_log(_LOG_INFO_, LOG_TX_START, samples.count);
+
+    // Pack as many of the queued samples as fit into each frame
+    while(samples.count > 0){
+        uint8_t n;
+
+        w.begin(frame, sizeof(frame));
+        n = write_batch(&w);
+        Traits::xbee_write(frame, w.len);
+        samples.pop(n);
+    }
+
+    // Reset the board sample count so that
+    // goes through the sample loop again.
+    sample_count = 0;
+
+    print_log(_LOG_INFO_, LOG_TX_END, 0);
+}
+
+/******************************
+ *
+ * Name:        board_core::write_batch
+ * Returns:     Number of samples written
+ * Parameter:   Frame writer of an empty frame
+ * Description: Write the oldest queued samples into one frame.
+ *              A lone sample is written in full until the time
+ *              is synced. A batch is delta coded: the epoch of
+ *              the first sample and the clock drift, the first
+ *              sample in full, then each one as zig-zag varint
+ *              deltas from the one before, which fits 2 to 4
+ *              times as many samples. Without
+ *              _BOARD_DELTA_BATCH_ the samples are written in
+ *              full back to back and the receiver splits them
+ *              on the schema length.
+ *
+ ******************************/
+template <class Traits>
+uint8_t board_core<Traits>::write_batch(struct frame_writer* w){
+    #ifdef _BOARD_DELTA_BATCH_
+    uint8_t n_at;
+    uint8_t n = 1;
+    int32_t prev_step = 0;
+    const packet_t* first = &samples.peek(0);
+    uint64_t epoch;
+
+    // Only a batch carries the epoch
+    if(samples.count == 1 && !time_sync_valid()){
+        Traits::write(w, first);
+        return 1;
+    }
+
+    w->u16(Traits::schema | _SCHEMA_DELTA_);
+    n_at = w->len;
+    w->u8(0);
+    epoch = time_sync_epoch_ms((uint64_t)first->overflow_num << 32 | first->uptime_ms);
+    w->u32(epoch / 1000);
+    w->u16(epoch % 1000);
+    w->varint(schema_zigzag(time_sync_drift_ppm()));
+    Traits::write(w, first);
+
+    while(n < samples.count){
+        const packet_t* prev = &samples.peek(n - 1);
+        const packet_t* p = &samples.peek(n);
+        int32_t step = p->uptime_ms - prev->uptime_ms;
+        uint8_t mark = w->len;
+
+        // The sample period is nearly constant, code the change
+        // of the uptime step rather than the step itself
+        w->varint(schema_zigzag(step - prev_step));
+        Traits::write_delta(w, p, prev);
+        if(w->overflow){
+            w->rewind(mark);
+            break;
+        }
+        prev_step = step;
+        n++;
+    }
+
+    w->buf[n_at] = n;
+    return n;
+    #else
+    const uint8_t per_frame = _BOARD_FRAME_PAYLOAD_ / Traits::packet_len;
+    uint8_t n = min(samples.count, per_frame);
+
+    for(uint8_t i = 0; i < n; i++){
+        Traits::write(w, &samples.peek(i));
+    }
+    return n;
+    #endif
+}
+
+/******************************
+ *
+ * Name:        board_core::xbee_poll
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Handle incoming XBee frames and let the radio
+ *              go back to sleep when it is done
+ *
+ ******************************/
+template <class Traits>
+void board_core<Traits>::xbee_poll(void){
+    PROF_SCOPE(PROF_XBEE_POLL);
+
+    Traits::xbee_poll();
+}
+
+/******************************
+ *
+ * Name:        board_core::sen_due
+ * Returns:     1 if a sample or irradiance reading is due within
+ *              the warm-up time of the sensor rail
+ * Parameter:   Nothing
+ * Description: Nothing
+ *
+ ******************************/
+template <class Traits>
+uint8_t board_core<Traits>::sen_due(void){
+    const uint64_t due_ms = clock_ms() + Traits::sen_warmup_ms;
+
+    return due_ms >= next_sample_ms || due_ms >= prev_irr_ms + _BOARD_IRR_PERIOD_MS_;
+}
+
+/******************************
+ *
+ * Name:        board_core::ready_sen_warmup
+ * Returns:     Integer indicating if the sensor rail should go on
+ * Parameter:   Nothing
+ * Description: The rail is off and a sensor read is due within
+ *              Traits::sen_warmup_ms
+ *
+ ******************************/
+template <class Traits>
+int board_core<Traits>::ready_sen_warmup(void){
+    return !sen_power_is_on() && sen_due();
+}
+
+/******************************
+ *
+ * Name:        board_core::sen_warmup
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Switch the sensor rail on, re-initializing the
+ *              devices if it was off
+ *
+ ******************************/
+template <class Traits>
+void board_core<Traits>::sen_warmup(void){
+    if(sen_power_on()){
+        Traits::sen_power_up();
+    }
+}
+
+/******************************
+ *
+ * Name:        board_core::sen_wait
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Switch the sensor rail on if needed and idle
+ *              until the devices are warm
+ *
+ ******************************/
+template <class Traits>
+void board_core<Traits>::sen_wait(void){
+    sen_warmup();
+    sen_power_wait(Traits::sen_warmup_ms);
+}
+
+/******************************
+ *
+ * Name:        board_core::sen_rest
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Cut the sensor rail after a read, unless the
+ *              next one is too close to warm up again
+ *
+ ******************************/
+template <class Traits>
+void board_core<Traits>::sen_rest(void){
+    if(!sen_due()){
+        sen_power_off();
+    }
+}
+
+/******************************
+ *
+ * Name:        board_core::next_event_ms
+ * Returns:     Time in ms until the next task is due
+ * Parameter:   Nothing
+ * Description: Used by the scheduler to decide how long
+ *              the MCU can sleep before the next sample
+ *              or heartbeat.
+ *
+ ******************************/
+template <class Traits>
+unsigned long board_core<Traits>::next_event_ms(void){
+    const uint64_t now = clock_ms();
+    unsigned long next_ms;
+    uint64_t delta_ms;
+    // Wake early enough to warm the sensor rail up
+    const unsigned long lead_ms = sen_power_is_on() ? 0 : Traits::sen_warmup_ms;
+
+    // Don't sleep while there is console input to handle
+    if(ready_run_cmd()){
+        return 0;
+    }
+
+    // Only idle while a TX status or a reply is expected, the
+    // first byte would be lost in power-down
+    if(Traits::xbee_awake()){
+        return 1;
+    }
+
+    if(now + lead_ms >= next_sample_ms){
+        return 0;
+    }
+    next_ms = next_sample_ms - now - lead_ms;
+
+    delta_ms = now - prev_irr_ms + lead_ms;
+    if(delta_ms >= _BOARD_IRR_PERIOD_MS_){
+        return 0;
+    }
+    if(_BOARD_IRR_PERIOD_MS_ - delta_ms < next_ms){
+        next_ms = _BOARD_IRR_PERIOD_MS_ - delta_ms;
+    }
+
+    if(now >= next_heartbeat_ms){
+        return 0;
+    }
+    if(next_heartbeat_ms - now < next_ms){
+        next_ms = next_heartbeat_ms - now;
+    }
+
+    return next_ms;
+}
+
+#endif
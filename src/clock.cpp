@@ -0,0 +1,32 @@
+/*******************************
+ *
+ * File: clock.cpp
+ *
+ * Monotonic 64-bit uptime. See clock.h.
+ *
+ ******************************/
+
+#include "clock.h"
+#include <overflow_checker.h>
+
+static unsigned long last_ms = 0;
+static uint32_t wraps = 0;
+
+/******************************
+ *
+ * Name:        clock_ms
+ * Returns:     Milliseconds since boot, never wraps
+ * Parameter:   Nothing
+ * Description: Read millis() and count a wrap whenever it went
+ *              backwards since the last call
+ *
+ ******************************/
+uint64_t clock_ms(void){
+    unsigned long now = millis();
+
+    if(chk_overflow(now, last_ms)){
+        wraps++;
+    }
+    last_ms = now;
+    return (uint64_t)wraps << 32 | now;
+}
@@ -0,0 +1,27 @@
+/*******************************
+ *
+ * File: clock.h
+ *
+ * Monotonic 64-bit uptime. millis() wraps after about 49.7 days;
+ * clock_ms() extends it by counting the wraps with chk_overflow()
+ * from SCEL_MillisOverflow. The scheduler adds the time spent in
+ * power-down back to millis(), so the clock keeps counting across
+ * sleep.
+ *
+ * A wrap is only seen if clock_ms() is called at least once per
+ * wrap period. The main loop calls it on every pass, and the
+ * watchdog wakes the MCU every few seconds at most. Main context
+ * only, not from interrupts.
+ *
+ * Packets carry the low 32 bits as uptime_ms and the next 8 bits,
+ * the wrap count, as overflow_num, good for 34 years.
+ *
+ ******************************/
+
+#include <Arduino.h>
+
+#ifndef CLOCK_H
+#define CLOCK_H
+
+uint64_t clock_ms(void);
+#endif
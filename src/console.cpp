@@ -0,0 +1,151 @@
+/*******************************
+ *
+ * File: console.cpp
+ *
+ * Non-blocking serial console. See console.h.
+ *
+ ******************************/
+
+#include "console.h"
+#include <ctype.h>
+
+static char line[_CONSOLE_LINE_MAX_];
+static uint8_t line_len = 0;
+static uint8_t line_overflow = 0;
+
+// Command line received over the radio, run before serial input
+static char rx_line[_CONSOLE_LINE_MAX_];
+static uint8_t rx_pending = 0;
+
+/******************************
+ *
+ * Name:        console_rx
+ * Returns:     Nothing
+ * Parameter:   RX data payload, its length
+ * Description: Take a payload received over the radio as one
+ *              command line. A trailing CR or LF is allowed.
+ *              Replaces a line that has not been run yet.
+ *
+ ******************************/
+void console_rx(const uint8_t* data, uint8_t len){
+    uint8_t i;
+
+    while(len > 0 && (data[len - 1] == '\r' || data[len - 1] == '\n')){
+        len--;
+    }
+    if(len == 0){
+        return;
+    }
+    if(len >= _CONSOLE_LINE_MAX_){
+        Serial.println(F("Command too long"));
+        return;
+    }
+
+    for(i = 0; i < len; i++){
+        rx_line[i] = toupper(data[i]);
+    }
+    rx_line[len] = '\0';
+    rx_pending = 1;
+}
+
+/******************************
+ *
+ * Name:        console_ready
+ * Returns:     Non-zero if there is input for console_read
+ * Parameter:   Nothing
+ * Description: Nothing
+ *
+ ******************************/
+uint8_t console_ready(void){
+    return rx_pending || Serial.available();
+}
+
+/******************************
+ *
+ * Name:        console_read
+ * Returns:     The next complete command line, NULL if none
+ * Parameter:   Nothing
+ * Description: Take the characters received so far without
+ *              waiting for more. Lines end in CR or LF, empty
+ *              lines are skipped and letters are upper cased.
+ *              A line received over the radio comes first.
+ *              The line stays valid until the next call.
+ *
+ ******************************/
+char* console_read(void){
+    int c;
+
+    if(rx_pending){
+        rx_pending = 0;
+        return rx_line;
+    }
+
+    while((c = Serial.read()) >= 0){
+        if(c == '\r' || c == '\n'){
+            if(line_overflow){
+                Serial.println(F("Command too long"));
+            }
+            else if(line_len > 0){
+                line[line_len] = '\0';
+                line_len = 0;
+                return line;
+            }
+            line_len = 0;
+            line_overflow = 0;
+        }
+        else if(line_len < _CONSOLE_LINE_MAX_ - 1){
+            line[line_len++] = toupper(c);
+        }
+        else{
+            line_overflow = 1;
+        }
+    }
+    return NULL;
+}
+
+/******************************
+ *
+ * Name:        console_run
+ * Returns:     1 if the line matched a command of the table
+ * Parameter:   Command line, PROGMEM table, number of entries
+ * Description: Run the command whose name is the whole line
+ *
+ ******************************/
+uint8_t console_run(const char* cmd, const struct console_cmd* table, uint8_t n){
+    uint8_t i;
+    uint8_t j;
+
+    for(i = 0; i < n; i++){
+        const char* text = (const char*)pgm_read_ptr(&table[i].text);
+        char t;
+
+        for(j = 0; ; j++){
+            t = pgm_read_byte(text + j);
+            if(t == ' ' || t == '\0' || t != cmd[j]){
+                break;
+            }
+        }
+        if((t == ' ' || t == '\0') && cmd[j] == '\0'){
+            void (*fn)(void) = (void (*)(void))pgm_read_ptr(&table[i].fn);
+            fn();
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/******************************
+ *
+ * Name:        console_help
+ * Returns:     Nothing
+ * Parameter:   PROGMEM table, number of entries
+ * Description: Print the name and help of every command
+ *
+ ******************************/
+void console_help(const struct console_cmd* table, uint8_t n){
+    uint8_t i;
+
+    for(i = 0; i < n; i++){
+        Serial.println((const __FlashStringHelper*)pgm_read_ptr(&table[i].text));
+    }
+}
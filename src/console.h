@@ -0,0 +1,42 @@
+/*******************************
+ *
+ * File: console.h
+ *
+ * Non-blocking, line buffered serial console. Characters are
+ * collected as they arrive, a line is run once its newline is
+ * in, and nothing ever waits for the operator, so sampling and
+ * transmitting carry on while the console is in use. Lines
+ * also come in over the radio: every XBee RX data payload that
+ * isn't a time sync is one command line.
+ *
+ * Commands are kept in PROGMEM tables. Each entry is one flash
+ * string, the command name followed by " - " and its help text,
+ * and the function that runs it:
+ *
+ *   static const char cmd_post[] PROGMEM = "P - Run Power On Self-Test";
+ *   static const struct console_cmd cmds[] PROGMEM = {
+ *       {cmd_post, run_post},
+ *   };
+ *
+ ******************************/
+
+#include <Arduino.h>
+#include <avr/pgmspace.h>
+
+// Longest command line, including the terminating NUL
+#define _CONSOLE_LINE_MAX_ 16
+
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+struct console_cmd{
+    const char* text;           // PROGMEM "NAME - help"
+    void (*fn)(void);
+};
+
+void console_rx(const uint8_t* data, uint8_t len);
+uint8_t console_ready(void);
+char* console_read(void);
+uint8_t console_run(const char* line, const struct console_cmd* table, uint8_t n);
+void console_help(const struct console_cmd* table, uint8_t n);
+#endif
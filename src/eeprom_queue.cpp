@@ -0,0 +1,199 @@
+/*******************************
+ *
+ * File: eeprom_queue.cpp
+ *
+ * EEPROM circular queue of XBee payloads. See eeprom_queue.h.
+ *
+ * Slots are written with EEPROM.update, which skips bytes that
+ * already hold the value, so unchanged bytes cost no erase cycle.
+ *
+ ******************************/
+
+#include "eeprom_queue.h"
+
+static_assert(_EEPROM_QUEUE_SLOTS_ >= 2 && _EEPROM_QUEUE_SLOTS_ < 128,
+              "EEPROM queue needs 2 to 127 slots");
+
+static uint8_t queue_head = 0;          // Slot of the oldest payload
+static uint8_t queue_count = 0;
+static uint8_t queue_seq = 0;           // seq of the next push
+
+static inline int slot_addr(uint8_t slot){
+    return _EEPROM_QUEUE_START_ + (int)slot * _EEPROM_QUEUE_SLOT_;
+}
+
+static inline uint8_t slot_next(uint8_t slot){
+    return slot + 1 < _EEPROM_QUEUE_SLOTS_ ? slot + 1 : 0;
+}
+
+static inline uint8_t slot_prev(uint8_t slot){
+    return slot ? slot - 1 : _EEPROM_QUEUE_SLOTS_ - 1;
+}
+
+/******************************
+ *
+ * Name:        slot_len
+ * Returns:     Length of the payload in a slot, 0 if free
+ * Parameter:   Slot
+ * Description: Erased (0xFF) and corrupt lengths read as free
+ *
+ ******************************/
+static uint8_t slot_len(uint8_t slot){
+    uint8_t len = EEPROM.read(slot_addr(slot) + 1);
+
+    return len > _EEPROM_QUEUE_DATA_ ? 0 : len;
+}
+
+static inline uint8_t slot_seq(uint8_t slot){
+    return EEPROM.read(slot_addr(slot));
+}
+
+/******************************
+ *
+ * Name:        eeprom_queue_open
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Find the payloads left in EEPROM before the
+ *              last reset. The oldest is the first used slot
+ *              after a free one, or the break in seq if every
+ *              slot is used.
+ *
+ ******************************/
+void eeprom_queue_open(void){
+    uint8_t used = 0;
+    uint8_t slot;
+    uint8_t i;
+
+    queue_head = 0;
+    queue_count = 0;
+    queue_seq = 0;
+
+    for(i = 0; i < _EEPROM_QUEUE_SLOTS_; i++){
+        if(slot_len(i)){
+            used++;
+        }
+    }
+    if(used == 0){
+        return;
+    }
+
+    for(i = 0; i < _EEPROM_QUEUE_SLOTS_; i++){
+        if(used < _EEPROM_QUEUE_SLOTS_){
+            if(slot_len(i) && !slot_len(slot_prev(i))){
+                break;
+            }
+        }
+        else if((uint8_t)(slot_seq(slot_prev(i)) + 1) != slot_seq(i)){
+            break;
+        }
+    }
+    queue_head = i < _EEPROM_QUEUE_SLOTS_ ? i : 0;
+
+    // Count the run of used slots. Anything after a gap is left
+    // over from a corrupt write and will be overwritten.
+    slot = queue_head;
+    while(queue_count < _EEPROM_QUEUE_SLOTS_ && slot_len(slot)){
+        queue_seq = slot_seq(slot) + 1;
+        queue_count++;
+        slot = slot_next(slot);
+    }
+}
+
+/******************************
+ *
+ * Name:        eeprom_queue_count
+ * Returns:     Number of payloads in the queue
+ * Parameter:   Nothing
+ * Description: Nothing
+ *
+ ******************************/
+uint8_t eeprom_queue_count(void){
+    return queue_count;
+}
+
+/******************************
+ *
+ * Name:        eeprom_queue_push
+ * Returns:     1 if stored, 0 if the length is invalid
+ * Parameter:   Payload, length
+ * Description: Append a payload, overwriting the oldest one
+ *              if the queue is full. Blocks for about 3.3 ms
+ *              per changed byte.
+ *
+ ******************************/
+uint8_t eeprom_queue_push(const uint8_t* data, uint8_t len){
+    uint8_t slot;
+    int addr;
+    uint8_t i;
+
+    if(len == 0 || len > _EEPROM_QUEUE_DATA_){
+        return 0;
+    }
+    if(queue_count == _EEPROM_QUEUE_SLOTS_){
+        eeprom_queue_pop();
+    }
+
+    slot = queue_head + queue_count;
+    if(slot >= _EEPROM_QUEUE_SLOTS_){
+        slot -= _EEPROM_QUEUE_SLOTS_;
+    }
+    addr = slot_addr(slot);
+
+    // Free the slot while it is being written
+    EEPROM.update(addr + 1, 0);
+    EEPROM.update(addr, queue_seq);
+    for(i = 0; i < len; i++){
+        EEPROM.update(addr + 2 + i, data[i]);
+    }
+    EEPROM.update(addr + 1, len);
+
+    queue_seq++;
+    queue_count++;
+    return 1;
+}
+
+/******************************
+ *
+ * Name:        eeprom_queue_peek
+ * Returns:     Length of the oldest payload, 0 if the queue is
+ *              empty
+ * Parameter:   Buffer, size of the buffer
+ * Description: Copy the oldest payload without removing it
+ *
+ ******************************/
+uint8_t eeprom_queue_peek(uint8_t* data, uint8_t size){
+    uint8_t len;
+    int addr;
+    uint8_t i;
+
+    if(queue_count == 0){
+        return 0;
+    }
+
+    len = slot_len(queue_head);
+    if(len > size){
+        len = size;
+    }
+    addr = slot_addr(queue_head) + 2;
+    for(i = 0; i < len; i++){
+        data[i] = EEPROM.read(addr + i);
+    }
+    return len;
+}
+
+/******************************
+ *
+ * Name:        eeprom_queue_pop
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Free the slot of the oldest payload
+ *
+ ******************************/
+void eeprom_queue_pop(void){
+    if(queue_count == 0){
+        return;
+    }
+    EEPROM.update(slot_addr(queue_head) + 1, 0);
+    queue_head = slot_next(queue_head);
+    queue_count--;
+}
@@ -0,0 +1,42 @@
+/*******************************
+ *
+ * File: eeprom_queue.h
+ *
+ * Circular queue of XBee payloads in EEPROM. Frames that could
+ * not be delivered are stored here and sent again once the link
+ * is back, and the queue survives a reset.
+ *
+ * The queue starts after the configuration bytes at the start
+ * of the EEPROM (node address in bytes 2-3) and is split into
+ * fixed slots:
+ *
+ *   seq, len, payload[_EEPROM_QUEUE_DATA_]
+ *
+ * A slot with len 0 (or 0xFF, erased) is free. len is written
+ * last, so a slot interrupted by a reset is not picked up. seq
+ * counts up with every push and orders the slots when the queue
+ * is full. There is no header to rewrite, so the wear is spread
+ * over every slot. When the queue is full the oldest payload is
+ * overwritten.
+ *
+ ******************************/
+
+#include <Arduino.h>
+#include <EEPROM.h>
+
+#define _EEPROM_QUEUE_START_ 16
+#define _EEPROM_QUEUE_END_ (E2END + 1)
+#define _EEPROM_QUEUE_DATA_ 84          // One ZigBee unicast payload (ATNP)
+#define _EEPROM_QUEUE_SLOT_ (_EEPROM_QUEUE_DATA_ + 2)
+#define _EEPROM_QUEUE_SLOTS_ \
+    ((_EEPROM_QUEUE_END_ - _EEPROM_QUEUE_START_) / _EEPROM_QUEUE_SLOT_)
+
+#ifndef EEPROM_QUEUE_H
+#define EEPROM_QUEUE_H
+
+void eeprom_queue_open(void);
+uint8_t eeprom_queue_count(void);
+uint8_t eeprom_queue_push(const uint8_t* data, uint8_t len);
+uint8_t eeprom_queue_peek(uint8_t* data, uint8_t size);
+void eeprom_queue_pop(void);
+#endif
@@ -11,6 +11,7 @@
 
 /* Program Libraries */
 #include "log.h"
+#include "sched.h"
 
 #ifdef GA
 #include "gen_apple/ga_board.h"
@@ -23,7 +24,6 @@
 /* Arudino Libraries */
 #include <Wire.h>
 #include <EEPROM.h>
-#include <SoftwareSerial.h>
 
 /* External Libraries */
 #include <SHT1x.h>
@@ -37,16 +37,17 @@
 #include <XBee.h>
 
 #ifdef GA
-struct ga_board board;
+static ga_board board;
 #endif
 
 #ifdef GC
-struct gc_board board;
+static gc_board board;
 #endif
 
 #ifdef GD
-struct gd_board board;
+static gd_board board;
 #endif
+
 /*********************************************
  *
  *    Name:        setup
@@ -58,21 +59,11 @@ struct gd_board board;
  *
  ********************************************/
 void setup(){
-    #ifdef GA
-    ga_board_init(&board);
-    #endif
-
-    #ifdef GC
-    gc_board_init(&board);
-    #endif
-
-    #ifdef GD
-    gd_board_init(&board);
-    #endif
-
+    board.init();
     board.print_build_opts();
-    board.setup(&board);
+    board.setup();
     board.post();
+    sched_open();
 
     #ifdef _BCFG_ONLY_POST
     // Stop execution if the ONLY_POST build configuration
@@ -89,12 +80,21 @@ void setup(){
  *    Description: Main program function, runs constantly.
  *                     Executed after setup(), and will
  *                     continue running indefinitely,
- *                     unless conditions stop it.
+ *                     unless conditions stop it. Sleeps
+ *                     until the next task is due.
  *
  ********************************************/
 void loop(){
-    if(board.ready_sample(&board))  board.sample(&board);
-    if(board.ready_tx(&board))      board.tx(&board);
-    if(board.ready_run_cmd(&board))      board.run_cmd(&board);
-    if(board.ready_heartbeat_tx(&board))      board.heartbeat_tx(&board);
+    board.xbee_poll();
+
+    if(board.ready_sen_warmup())  board.sen_warmup();
+    if(board.ready_irr_sample())  board.irr_sample();
+    if(board.ready_sample())  board.sample();
+    if(board.ready_tx())      board.tx();
+    if(board.ready_run_cmd())      board.run_cmd();
+    if(board.ready_heartbeat_tx())      board.heartbeat_tx();
+
+    log_flush(0);
+
+    sched_sleep(board.next_event_ms());
 }
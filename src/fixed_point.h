@@ -0,0 +1,79 @@
+/*******************************
+ *
+ * File: fixed_point.h
+ *
+ * Integer conversion kernels used by the device read paths
+ * instead of soft-float. A conversion raw * num / den is done
+ * as one 32 bit multiply by a Q16 factor (num / den scaled by
+ * 2^16) that is derived at compile time.
+ *
+ * The kernels round to the nearest integer while the float
+ * code they replace truncated, so results can differ by one
+ * LSB. fixed_q16_check() verifies this at compile time for
+ * every possible raw reading.
+ *
+ ******************************/
+
+#include <Arduino.h>
+
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+// ATmega328P ADC: 10 bit, 5 V reference
+#define _FIXED_ADC_MAX_ 1023
+#define _FIXED_ADC_VREF_MV_ 5000
+
+// ADS1115 at gain 2/3: 0.1875 mV per count, rounded to 188 uV
+// as in the original float code
+#define _FIXED_ADS1115_MAX_ 0xFFFF
+#define _FIXED_ADS1115_UV_ 188
+
+// HIH613x: 14 bit humidity and temperature counts
+#define _FIXED_HIH613X_MAX_ 16383
+
+/******************************
+ *
+ * Name:        fixed_q16
+ * Returns:     num / den as a rounded Q16 factor
+ * Parameter:   Numerator, denominator
+ * Description: Only meant to be evaluated at compile time
+ *
+ ******************************/
+constexpr uint32_t fixed_q16(uint32_t num, uint32_t den){
+    return (uint32_t)((((uint64_t)num << 16) + den/2) / den);
+}
+
+/******************************
+ *
+ * Name:        fixed_mul_q16
+ * Returns:     raw * factor, rounded
+ * Parameter:   Raw reading, Q16 factor from fixed_q16
+ * Description: raw * q16 must fit in 32 bits, see
+ *              fixed_q16_check
+ *
+ ******************************/
+constexpr uint32_t fixed_mul_q16(uint32_t raw, uint32_t q16){
+    return (raw * q16 + 0x8000UL) >> 16;
+}
+
+/******************************
+ *
+ * Name:        fixed_q16_check
+ * Returns:     true if the kernel is within one LSB of
+ *              raw * num / den for every raw in [lo, hi]
+ * Parameter:   Range of raw readings, num, den
+ * Description: Splits the range in halves so the recursion
+ *              depth stays at log2 of the range. Used in
+ *              static_assert next to each scale factor.
+ *
+ ******************************/
+constexpr bool fixed_q16_check(uint32_t lo, uint32_t hi, uint32_t num, uint32_t den){
+    return lo < hi ?
+        fixed_q16_check(lo, lo + (hi - lo)/2, num, den) &&
+        fixed_q16_check(lo + (hi - lo)/2 + 1, hi, num, den) :
+        (uint64_t)lo * fixed_q16(num, den) + 0x8000UL <= 0xFFFFFFFFUL &&
+        fixed_mul_q16(lo, fixed_q16(num, den)) + 1 >= (uint64_t)lo * num / den &&
+        fixed_mul_q16(lo, fixed_q16(num, den)) <= (uint64_t)lo * num / den + 1;
+}
+
+#endif
@@ -0,0 +1,101 @@
+/*******************************
+ *
+ * File: frame_writer.h
+ *
+ * Serializes packet fields into an XBee payload buffer in an
+ * explicit packed little-endian layout, independent of how the
+ * compiler lays out the packet structs in memory.
+ *
+ ******************************/
+
+#include <Arduino.h>
+
+#ifndef FRAME_WRITER_H
+#define FRAME_WRITER_H
+
+struct frame_writer{
+    uint8_t* buf;
+    uint8_t size;       // Size of buf
+    uint8_t len;        // Bytes written so far
+    uint8_t overflow;   // A byte was dropped, the buffer is full
+
+    /******************************
+     *
+     * Name:        frame_writer::begin
+     * Returns:     Nothing
+     * Parameter:   Buffer to write into, size of the buffer
+     * Description: Start a new payload
+     *
+     ******************************/
+    void begin(uint8_t* dst, uint8_t dst_size){
+        buf = dst;
+        size = dst_size;
+        len = 0;
+        overflow = 0;
+    }
+
+    /******************************
+     *
+     * Name:        frame_writer::u8
+     * Returns:     Nothing
+     * Parameter:   Value to append
+     * Description: Append one byte. Bytes past the end of the
+     *              buffer are dropped.
+     *
+     ******************************/
+    void u8(uint8_t v){
+        if(len < size){
+            buf[len++] = v;
+        }
+        else{
+            overflow = 1;
+        }
+    }
+
+    void u16(uint16_t v){
+        u8(v);
+        u8(v >> 8);
+    }
+
+    void i16(int16_t v){
+        u16((uint16_t)v);
+    }
+
+    void u32(uint32_t v){
+        u16(v);
+        u16(v >> 16);
+    }
+
+    /******************************
+     *
+     * Name:        frame_writer::varint
+     * Returns:     Nothing
+     * Parameter:   Value to append
+     * Description: Append an unsigned LEB128 varint, 7 bits a
+     *              byte, low bits first, 1 to 5 bytes
+     *
+     ******************************/
+    void varint(uint32_t v){
+        while(v >= 0x80){
+            u8(v | 0x80);
+            v >>= 7;
+        }
+        u8(v);
+    }
+
+    /******************************
+     *
+     * Name:        frame_writer::rewind
+     * Returns:     Nothing
+     * Parameter:   Length to go back to
+     * Description: Drop what was written after len, used to undo
+     *              a record that did not fit
+     *
+     ******************************/
+    void rewind(uint8_t to_len){
+        len = to_len;
+        overflow = 0;
+    }
+};
+
+#endif
@@ -5,68 +5,130 @@
 #include "ga_dev_batt.h"
 #include "ga_dev_spanel.h"
 #include "ga_dev_eeprom_naddr.h"
+#include "../prof.h"
+#include "../schema.h"
+#include "../board_core.h"
 
 #ifndef GA_BOARD_H
 #define GA_BOARD_H
 
 struct ga_packet{
-    uint16_t schema;
-    uint16_t node_addr;             // Address of Arduino
-    uint32_t uptime_ms;             // Time since start of program
-    uint16_t batt_mv;               // Battery Voltage (in milli volts)
-    uint16_t panel_mv;              // Panel Voltage (in milli volts)
-    uint32_t bmp085_press_pa;       // Pressure Value (in pascals)
-    int16_t bmp085_temp_decic;      // Temperature Value (in celsius)
-    uint16_t humidity_centi_pct;
-    uint16_t apogee_w_m2;
+    SCHEMA_STRUCT(SCHEMA_GA_FIELDS)
 };
 
-struct ga_heartbeat_packet{
-    uint16_t schema;
-    uint16_t node_addr;             // Address of Arduino
-    uint32_t uptime_ms;             // Time since start of program
-    uint16_t batt_mv;               // Battery Voltage (in milli volts)
-};
+struct ga_traits{
+    typedef struct ga_packet packet_t;
 
+    static const uint16_t schema = _SCHEMA_GA_;
+    static const int8_t pin_sen_en = -1;
+    static const uint16_t sen_warmup_ms = 0;
+    static const uint8_t packet_len = SCHEMA_LEN(SCHEMA_GA_FIELDS);
 
-// Legacy apple schema.
-typedef struct {
-    uint16_t schema;
-    uint16_t address;               // Address of Arduino
-    uint8_t overflow_num;           // Number of times millis overflowed (happens ~every 49 days)
-    uint32_t uptime_ms;             // Time since start of program
-    uint8_t n;                      // number of data points in packet 0..30
-    uint16_t batt_mv[6];            // Battery Voltage (in milli volts)
-    uint16_t panel_mv[6];           // Panel Voltage (in milli volts)
-    uint32_t bmp085_press_pa;       // Pressure Value (in pascals)
-    int16_t bmp085_temp_decic;      // Temperature Value (in celsius)
-    uint16_t humidity_centi_pct;
-    uint16_t apogee_w_m2[20];
-} schema_3;
-
-
-struct ga_board{
-    void (*setup)(struct ga_board* b);
-    void (*post)(void);
-    void (*sample)(struct ga_board* b);
-    void (*run_cmd)(struct ga_board* b);
-    void (*print_build_opts)(void);
-    void (*tx)(struct ga_board* b);
-    int (*ready_tx)(struct ga_board* b);
-    int (*ready_sample)(struct ga_board* b);
-    int (*ready_run_cmd)(struct ga_board* b);
-
-    int (*ready_heartbeat_tx)(struct ga_board* b);
-    void (*heartbeat_tx)(struct ga_board* b);
-
-    unsigned long prev_sample_ms;
-    unsigned long prev_heartbeat_ms;
-    int sample_count;
-    uint16_t node_addr;
-    struct ga_packet data_packet;
-};
+    static void print_build_opts(void){
+        Serial.println(F("Gen: apple23"));
+    }
+
+    static void open(void){
+        adc_service_open();
+        ga_dev_xbee_open();
+        ga_dev_sht1x_open();
+        ga_dev_bmp085_open();
+        ga_dev_apogee_sp212_open();
+        ga_dev_batt_open();
+        ga_dev_spanel_open();
+        ga_dev_eeprom_naddr_open();
+    }
+
+    static void post(void){
+        ga_dev_eeprom_naddr_test();
+        ga_dev_sht1x_test();
+        ga_dev_bmp085_press_test();
+        ga_dev_bmp085_temp_test();
+        ga_dev_apogee_sp212_test();
+        ga_dev_batt_test();
+        ga_dev_spanel_test();
+    }
+
+    static void sen_power_up(void){}
+
+    static void sample_start(void){
+        adc_service_start();
+        ga_dev_bmp085_start();
+    }
+
+    static void sample(packet_t* data_packet){
+        // The BMP085 pressure conversion runs while the
+        // SHT1x (bit banged, blocking) is read
+        data_packet->batt_mv             = PROF_CALL(PROF_READ_BATT, ga_dev_batt_read());
+        data_packet->panel_mv            = PROF_CALL(PROF_READ_SPANEL, ga_dev_spanel_read());
+        data_packet->bmp085_temp_decic   = PROF_CALL(PROF_READ_TEMP, ga_dev_bmp085_read_temp());
+        data_packet->humidity_centi_pct  = PROF_CALL(PROF_READ_HUMIDITY, ga_dev_sht1x_read());
+        data_packet->bmp085_press_pa     = PROF_CALL(PROF_READ_PRESS, ga_dev_bmp085_read_press());
+    }
+
+    // Wire layout of packet_t, see schema.h
+    static void write(frame_writer* w, const packet_t* p){
+        SCHEMA_WRITE(SCHEMA_GA_FIELDS)
+    }
+
+    static void write_delta(frame_writer* w, const packet_t* p, const packet_t* prev){
+        SCHEMA_DELTA(SCHEMA_GA_DATA)
+    }
+
+    // The irradiance is sampled every _BOARD_IRR_PERIOD_MS_ in the
+    // background, the packet carries the summary of the window
+    static uint16_t irr_read(void){
+        return PROF_CALL(PROF_READ_IRR, ga_dev_apogee_sp212_read());
+    }
 
+    static void irr_summary(packet_t* data_packet, const window_stats* irr){
+        data_packet->apogee_w_m2         = irr->mean();
+        data_packet->apogee_min_w_m2     = irr->lo;
+        data_packet->apogee_max_w_m2     = irr->hi;
+        data_packet->apogee_var          = irr->variance();
+    }
+
+    // Report-by-exception deadbands: a sample is only sent if a
+    // field moved more than this since the last reported sample
+    static uint8_t changed(const packet_t* a, const packet_t* b){
+        return board_moved(a->batt_mv, b->batt_mv, 20) ||
+               board_moved(a->panel_mv, b->panel_mv, 100) ||
+               board_moved(a->bmp085_press_pa, b->bmp085_press_pa, 20) ||
+               board_moved(a->bmp085_temp_decic, b->bmp085_temp_decic, 2) ||
+               board_moved(a->humidity_centi_pct, b->humidity_centi_pct, 1) ||
+               board_moved(a->apogee_w_m2, b->apogee_w_m2, 5);
+    }
+
+    static uint16_t naddr_read(void){
+        return ga_dev_eeprom_naddr_read();
+    }
+
+    static uint16_t batt_read(void){
+        return ga_dev_batt_read();
+    }
+
+    static void xbee_write(uint8_t* data, int data_len){
+        ga_dev_xbee_write(data, data_len);
+    }
+
+    static void xbee_write_once(uint8_t* data, int data_len){
+        ga_dev_xbee_write(data, data_len);
+    }
+
+    static void xbee_poll(void){
+        ga_dev_xbee_poll();
+    }
+
+    // The XBee sleep pins are not wired on this board, the radio
+    // is always on. Stay awake a while after a transmit for the reply.
+    static uint8_t xbee_awake(void){
+        return ga_dev_xbee_awake();
+    }
+
+    static void print_cmd_help(void){}
+    static uint8_t run_cmd(const char* line){ return 0; }
+};
 
-void ga_board_init(struct ga_board*);
+typedef board_core<ga_traits> ga_board;
 
 #endif
@@ -1,18 +1,39 @@
 #include "ga_dev_apogee_sp212.h"
+#include "../fixed_point.h"
+
+#define _GA_APOGEE_SP212_NUM_ _FIXED_ADC_VREF_MV_
+#define _GA_APOGEE_SP212_DEN_ _ADC_SERVICE_MAX_(_GA_APOGEE_SP212_ADC_BITS_)
+static constexpr uint32_t ga_apogee_sp212_q16 = fixed_q16(_GA_APOGEE_SP212_NUM_, _GA_APOGEE_SP212_DEN_);
+static_assert(fixed_q16_check(0, _GA_APOGEE_SP212_DEN_, _GA_APOGEE_SP212_NUM_, _GA_APOGEE_SP212_DEN_),
+              "ga_dev_apogee_sp212: fixed point scale off by more than one LSB");
+
+static uint8_t ga_apogee_sp212_adc;
 
 void ga_dev_apogee_sp212_open(void){
     pinMode(_PIN_GA_APOGEE_SP212_, INPUT);
+    ga_apogee_sp212_adc = adc_service_add(_PIN_GA_APOGEE_SP212_, _GA_APOGEE_SP212_ADC_BITS_);
 }
 
 int ga_dev_apogee_sp212_read_raw(void){
-    int value = analogRead(_PIN_GA_APOGEE_SP212_);
+    int value = adc_service_read(ga_apogee_sp212_adc);
     return value;
 }
 
 int ga_dev_apogee_sp212_read(void){
     int value = 555;
     #ifndef SEN_STUB
-    value = (float)analogRead(_PIN_GA_APOGEE_SP212_)*(5000.0/1023.0);
+    value = fixed_mul_q16(adc_service_read(ga_apogee_sp212_adc), ga_apogee_sp212_q16);
     #endif
     return value;
 }
+
+void ga_dev_apogee_sp212_test(void){
+    int apogee_sp212_val = ga_dev_apogee_sp212_read();
+    Serial.print(F("[P] apogee_sp212 solar irr value: "));
+    Serial.print(apogee_sp212_val);
+    Serial.println(" mV");
+
+    if(apogee_sp212_val < 0){
+        Serial.println(F("[P] \tError: apogee solar irr out of range"));
+    }
+}
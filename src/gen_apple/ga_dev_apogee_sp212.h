@@ -1,5 +1,8 @@
 #include <Arduino.h>
+#include "../adc_service.h"
 
+// Oversampled to 13 bit
+#define _GA_APOGEE_SP212_ADC_BITS_ 3
 #define _PIN_GA_APOGEE_SP212_ A2
 
 #ifndef GA_DEV_APOGEE_SP212_H
@@ -7,4 +10,5 @@
 void ga_dev_apogee_sp212_open(void);
 int ga_dev_apogee_sp212_read_raw(void);
 int ga_dev_apogee_sp212_read(void);
+void ga_dev_apogee_sp212_test(void);
 #endif
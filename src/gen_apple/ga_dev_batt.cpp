@@ -1,12 +1,22 @@
 #include "ga_dev_batt.h"
+#include "../fixed_point.h"
+
+#define _GA_BATT_NUM_ _FIXED_ADC_VREF_MV_
+#define _GA_BATT_DEN_ _ADC_SERVICE_MAX_(_GA_BATT_ADC_BITS_)
+static constexpr uint32_t ga_batt_q16 = fixed_q16(_GA_BATT_NUM_, _GA_BATT_DEN_);
+static_assert(fixed_q16_check(0, _GA_BATT_DEN_, _GA_BATT_NUM_, _GA_BATT_DEN_),
+              "ga_dev_batt: fixed point scale off by more than one LSB");
+
+static uint8_t ga_batt_adc;
 
 void ga_dev_batt_open(void){
     pinMode(_PIN_GA_BATT_, INPUT);
+    ga_batt_adc = adc_service_add(_PIN_GA_BATT_, _GA_BATT_ADC_BITS_);
 }
 
 int ga_dev_batt_read_raw(void){
     int value;
-    value = analogRead(_PIN_GA_BATT_);
+    value = adc_service_read(ga_batt_adc);
     return value;
 }
 
@@ -14,9 +24,19 @@ int ga_dev_batt_read(void){
     int val = 555;
 
     #ifndef SEN_STUB
-    float raw = (float)analogRead(_PIN_GA_BATT_) * (5.0/1023.0);
-    val = raw * 1000;
+    val = fixed_mul_q16(adc_service_read(ga_batt_adc), ga_batt_q16);
     #endif
 
     return val;
 }
+
+void ga_dev_batt_test(void){
+    int batt_val = ga_dev_batt_read();
+    Serial.print(F("[P] batt value: "));
+    Serial.print(batt_val);
+    Serial.println(" mV");
+
+    if(batt_val < 0){
+        Serial.println(F("[P] \tError: batt out of range"));
+    }
+}
@@ -1,5 +1,8 @@
 #include <Arduino.h>
+#include "../adc_service.h"
 
+// Oversampled to 12 bit
+#define _GA_BATT_ADC_BITS_ 2
 #define _PIN_GA_BATT_ A3
 
 #ifndef GA_DEV_BATT_H
@@ -7,4 +10,5 @@
 void ga_dev_batt_open(void);
 int ga_dev_batt_read_raw(void);
 int ga_dev_batt_read(void);
+void ga_dev_batt_test(void);
 #endif
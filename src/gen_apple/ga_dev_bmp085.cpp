@@ -1,15 +1,57 @@
 #include "ga_dev_bmp085.h"
 static Adafruit_BMP085 bmp085;
 
+// The BMP085 converts temperature, then pressure. The raw
+// temperature is kept for the pressure compensation.
+static struct sched_conv bmp085_conv;
+static uint8_t bmp085_press_pending = 0;
+static int32_t bmp085_ut = 0;
+
 void ga_dev_bmp085_open(void){
     bmp085.begin();
 }
 
+void ga_dev_bmp085_start(void){
+    uint8_t wait_ms = BMP085_TEMPDELAY;
+
+    #ifndef SEN_STUB
+    wait_ms = bmp085.startTemperature();
+    #endif
+
+    sched_conv_start(&bmp085_conv, wait_ms);
+    bmp085_press_pending = 0;
+}
+
+static void ga_dev_bmp085_collect_temp(void){
+    uint8_t wait_ms = 5;
+
+    if(!bmp085_conv.pending || bmp085_press_pending){
+        ga_dev_bmp085_start();
+    }
+    sched_conv_wait(&bmp085_conv);
+
+    // Start the pressure conversion right away so it runs
+    // while the other sensors are read
+    #ifndef SEN_STUB
+    bmp085_ut = bmp085.collectRawTemperature();
+    wait_ms = bmp085.startPressure();
+    #endif
+
+    sched_conv_start(&bmp085_conv, wait_ms);
+    bmp085_press_pending = 1;
+}
+
 uint32_t ga_dev_bmp085_read_press(void){
     uint32_t value = 80;
 
+    if(!bmp085_press_pending){
+        ga_dev_bmp085_collect_temp();
+    }
+    sched_conv_wait(&bmp085_conv);
+    bmp085_press_pending = 0;
+
     #ifndef SEN_STUB
-    value = bmp085.readPressure();
+    value = bmp085.computePressure(bmp085_ut, bmp085.collectRawPressure());
     #endif
 
     return value;
@@ -18,10 +60,37 @@ uint32_t ga_dev_bmp085_read_press(void){
 int16_t ga_dev_bmp085_read_temp(void){
     int16_t value = 89;
 
+    ga_dev_bmp085_collect_temp();
+
     #ifndef SEN_STUB
-    float value_f = bmp085.readTemperature();
-    value = value_f * 10;
+    value = bmp085.computeTemperatureDeci(bmp085_ut);
     #endif
 
     return value;
 }
+
+void ga_dev_bmp085_press_test(void){
+    int32_t bmp085_val = ga_dev_bmp085_read_press();
+    Serial.print(F("[P] bmp085 value: "));
+    Serial.print(bmp085_val/100);
+    Serial.print(F("."));
+    Serial.print((bmp085_val-bmp085_val/10)/1000);
+    Serial.println(" mb");
+
+    if(bmp085_val < 80000){
+        Serial.println(F("[P] \tError: bmp085 pressure out of range"));
+    }
+}
+
+void ga_dev_bmp085_temp_test(void){
+    uint16_t bmp085_temp = ga_dev_bmp085_read_temp();
+    Serial.print(F("[P] bmp085 temp: "));
+    Serial.print(bmp085_temp/10);
+    Serial.print(".");
+    Serial.print((bmp085_temp-bmp085_temp/10)/10);
+    Serial.println(F(" celsius"));
+
+    if(bmp085_temp < 0){
+        Serial.println(F("[P] \tError: bmp085 temperature out of range"));
+    }
+}
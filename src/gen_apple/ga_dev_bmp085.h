@@ -1,10 +1,14 @@
 #include <Arduino.h>
 #include <Adafruit_BMP085.h>
+#include "../sched.h"
 
 #ifndef GA_DEV_BMP085_H
 #define GA_DEV_BMP085_H
 void ga_dev_bmp085_open(void);
+void ga_dev_bmp085_start(void);
 int ga_dev_bmp085_avail(void);
 uint32_t ga_dev_bmp085_read_press(void);
 int16_t ga_dev_bmp085_read_temp(void);
+void ga_dev_bmp085_press_test(void);
+void ga_dev_bmp085_temp_test(void);
 #endif
@@ -6,3 +6,8 @@ uint16_t ga_dev_eeprom_naddr_read(void){
     uint32_t node_addr = EEPROM.read(2) | (EEPROM.read(3)<<8);
     return node_addr;
 }
+
+void ga_dev_eeprom_naddr_test(void){
+    Serial.print(F("[P] node addr: "));
+    Serial.println((int) ga_dev_eeprom_naddr_read());
+}
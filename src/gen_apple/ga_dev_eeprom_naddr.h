@@ -5,4 +5,5 @@
 #define GA_DEV_EEPROM_NADDR_H
 void ga_dev_eeprom_naddr_open(void);
 uint16_t ga_dev_eeprom_naddr_read(void);
+void ga_dev_eeprom_naddr_test(void);
 #endif
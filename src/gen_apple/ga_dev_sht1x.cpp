@@ -15,8 +15,19 @@ int ga_dev_sht1x_read(void)
     int value = 60;
 
     #ifndef SEN_STUB
-    value =  sht1x.readHumidity();
+    value =  sht1x.readHumidityCenti() / 100;
     #endif
 
     return value;
 }
+
+void ga_dev_sht1x_test(void){
+    int sht1x_val = ga_dev_sht1x_read();
+    Serial.print(F("[P] sht1x value: "));
+    Serial.print(sht1x_val);
+    Serial.println("\%");
+
+    if(sht1x_val < 0){
+        Serial.println(F("[P] \tError: Humidity out of range"));
+    }
+}
@@ -6,5 +6,6 @@
 void ga_dev_sht1x_open(void);
 int ga_dev_sht1x_avail(void);
 int ga_dev_sht1x_read(void);
+void ga_dev_sht1x_test(void);
 #endif
 
@@ -1,15 +1,38 @@
 #include "ga_dev_spanel.h"
+#include "../fixed_point.h"
+
+// Voltage divider halves the panel voltage, 70 mV diode drop
+#define _GA_SPANEL_NUM_ (2UL*_FIXED_ADC_VREF_MV_)
+#define _GA_SPANEL_DEN_ _ADC_SERVICE_MAX_(_GA_SPANEL_ADC_BITS_)
+#define _GA_SPANEL_OFFSET_MV_ 70
+static constexpr uint32_t ga_spanel_q16 = fixed_q16(_GA_SPANEL_NUM_, _GA_SPANEL_DEN_);
+static_assert(fixed_q16_check(0, _GA_SPANEL_DEN_, _GA_SPANEL_NUM_, _GA_SPANEL_DEN_),
+              "ga_dev_spanel: fixed point scale off by more than one LSB");
+
+static uint8_t ga_spanel_adc;
 
 void ga_dev_spanel_open(void){
     pinMode(_PIN_GA_SPANEL_, INPUT);
+    ga_spanel_adc = adc_service_add(_PIN_GA_SPANEL_, _GA_SPANEL_ADC_BITS_);
 }
 
 int ga_dev_spanel_read(void){
     int value = 555;
 
     #ifndef SEN_STUB
-    value = 2.0*(float)analogRead(_PIN_GA_SPANEL_)*(5000.0/1023.0)+(70.0);
+    value = fixed_mul_q16(adc_service_read(ga_spanel_adc), ga_spanel_q16) + _GA_SPANEL_OFFSET_MV_;
     #endif
 
     return value;
 }
+
+void ga_dev_spanel_test(void){
+    int spanel_val = ga_dev_spanel_read();
+    Serial.print(F("[P] spanel value: "));
+    Serial.print(spanel_val);
+    Serial.println(F(" mV"));
+
+    if(spanel_val < 100){
+        Serial.println(F("[P] \tERROR: spanel value out of range"));
+    }
+}
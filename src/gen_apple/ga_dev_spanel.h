@@ -1,10 +1,14 @@
 #include <Arduino.h>
+#include "../adc_service.h"
 
+// Oversampled to 12 bit
+#define _GA_SPANEL_ADC_BITS_ 2
 #define _PIN_GA_SPANEL_ A1
 
 #ifndef GA_DEV_SPANEL
 #define GA_DEV_SPANEL
 void ga_dev_spanel_open(void);
 int ga_dev_spanel_read(void);
+void ga_dev_spanel_test(void);
 #endif
 
@@ -1,19 +1,14 @@
 #include "ga_dev_xbee.h"
 
-void ga_dev_xbee_open(void)
-{
-    soft_serial.begin(9600);
-    xbee.begin(soft_serial);
-}
+static XBee xbee = XBee();
+static uint8_t xbee_rx_window = 0;
+static unsigned long xbee_tx_ms = 0;    // Time of the last transmit
 
-int ga_dev_xbee_avail(void)
-{
-    return Serial.available();
-}
-
-int ga_dev_xbee_read(void)
+void ga_dev_xbee_open(void)
 {
-    return Serial.read();
+    xbee_serial.begin(_GA_DEV_XBEE_BAUD_, _PIN_GA_XBEE_RX_, _PIN_GA_XBEE_TX_);
+    xbee.begin(xbee_serial);
+    xbee_rx_open();
 }
 
 void ga_dev_xbee_write(uint8_t *data, int data_len)
@@ -22,5 +17,41 @@ void ga_dev_xbee_write(uint8_t *data, int data_len)
     ZBTxRequest zbtx = ZBTxRequest(addr64, data, data_len);
 
     xbee.send(zbtx);
+    xbee_tx_ms = millis();
+    xbee_rx_window = 1;
 }
 
+void ga_dev_xbee_poll(void)
+{
+    struct xbee_rx_frame* f;
+
+    while((f = xbee_rx_peek()) != NULL){
+        switch(f->data[_XBEE_RX_API_ID_]){
+            case MODEM_STATUS_RESPONSE:
+                Serial.print(F("XBee modem status: "));
+                Serial.println(f->data[_XBEE_RX_MODEM_STATUS_], HEX);
+                break;
+            case ZB_RX_RESPONSE:
+                if(time_sync_rx(&f->data[_XBEE_RX_ZB_DATA_],
+                                f->len - _XBEE_RX_ZB_DATA_, f->ms)){
+                    break;
+                }
+                console_rx(&f->data[_XBEE_RX_ZB_DATA_], f->len - _XBEE_RX_ZB_DATA_);
+                break;
+        }
+        xbee_rx_pop();
+    }
+
+    if(xbee_rx_dropped()){
+        Serial.println(F("XBee RX frame dropped"));
+    }
+}
+
+uint8_t ga_dev_xbee_awake(void)
+{
+    if(xbee_rx_window && millis() - xbee_tx_ms < _GA_DEV_XBEE_RX_WINDOW_MS_){
+        return 1;
+    }
+    xbee_rx_window = 0;
+    return 0;
+}
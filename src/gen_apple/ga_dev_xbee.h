@@ -1,20 +1,25 @@
 #include <Arduino.h>
 #include <XBee.h>
-#include <SoftwareSerial.h>
+#include "../soft_uart.h"
+#include "../xbee_rx.h"
+#include "../time_sync.h"
+#include "../console.h"
 
-#define _GA_DEV_XBEE_BUFSIZE_ 150
+#define _PIN_GA_XBEE_RX_ 2
+#define _PIN_GA_XBEE_TX_ 9
+
+// Must match the XBee ATBD setting
+#define _GA_DEV_XBEE_BAUD_ 9600
+
+// Time the MCU stays out of power-down after a transmit, so the
+// start of a reply (time sync) is not lost while it wakes up
+#define _GA_DEV_XBEE_RX_WINDOW_MS_ 3000
 
 #ifndef GA_DEV_XBEE
 #define GA_DEV_XBEE
 void ga_dev_xbee_open(void);
-int ga_dev_xbee_avail(void);
-int ga_dev_xbee_read(void);
 void ga_dev_xbee_write(uint8_t* data, int data_len);
-
-static XBee xbee = XBee();
-
-const byte rx_pin = 2;
-const byte tx_pin = 9;
-static SoftwareSerial soft_serial(rx_pin, tx_pin);
+void ga_dev_xbee_poll(void);
+uint8_t ga_dev_xbee_awake(void);
 #endif
 
@@ -1,10 +1,15 @@
 #include "gc_dev_xbee.h"
+#include "gc_dev_ads1115.h"
 #include "gc_dev_batt.h"
 #include "gc_dev_spanel.h"
 #include "gc_dev_eeprom_naddr.h"
 #include "gc_dev_apogee_SP212.h"
 #include "gc_dev_honeywell_HIH6131.h"
 #include "gc_dev_adafruit_MPL115A2.h"
+#include "../prof.h"
+#include "../sen_power.h"
+#include "../schema.h"
+#include "../board_core.h"
 
 #ifndef GC_BOARD_H
 #define GC_BOARD_H
@@ -12,45 +17,159 @@
 #define _PIN_SEN_EN 4
 
 struct gc_packet{
-    uint16_t schema;
-    uint16_t node_addr;           // Address of Arduino
-    uint32_t uptime_ms;         // Time since start of program
-    uint16_t batt_mv;           // Battery Voltage (in milli volts)
-    uint16_t panel_mv;          // Panel Voltage (in milli volts)
-    uint16_t apogee_w_m2;
-    uint16_t hih6131_temp_centik; // Temperature (Celsius)
-    uint16_t hih6131_humidity_pct;  // Humidity (percentage)
-    uint32_t mpl115a2t1_press_pa;  // Pressure (kPa)
+    SCHEMA_STRUCT(SCHEMA_GC_FIELDS)
 };
 
-struct gc_heartbeat_packet{
-    uint16_t schema;
-    uint16_t node_addr;           // Address of Arduino
-    uint32_t uptime_ms;         // Time since start of program
-    uint16_t batt_mv;           // Battery Voltage (in milli volts)
+// Sensor Sampling Menu, console commands S1 to S7
+static void gc_cmd_sensors(void);
+
+static const char gc_cmd_s[] PROGMEM = "S - Sensor Sampling Menu";
+static const char gc_cmd_s1[] PROGMEM = "S1 - Node Address";
+static const char gc_cmd_s2[] PROGMEM = "S2 - HIH6131 Temperature (cK)";
+static const char gc_cmd_s3[] PROGMEM = "S3 - HIH6131 Humidity (%)";
+static const char gc_cmd_s4[] PROGMEM = "S4 - MPL115A2 Pressure (Pa)";
+static const char gc_cmd_s5[] PROGMEM = "S5 - SP212 Solar Irradiance (mW)";
+static const char gc_cmd_s6[] PROGMEM = "S6 - Battery Voltage (mW)";
+static const char gc_cmd_s7[] PROGMEM = "S7 - Solar Panel Voltage (mW)";
+
+static const struct console_cmd gc_cmds[] PROGMEM = {
+    {gc_cmd_s, gc_cmd_sensors},
+    {gc_cmd_s1, gc_dev_eeprom_naddr_test},
+    {gc_cmd_s2, gc_dev_honeywell_HIH6131_temp_centik_test},
+    {gc_cmd_s3, gc_dev_honeywell_HIH6131_humidity_pct_test},
+    {gc_cmd_s4, gc_dev_adafruit_MPL115A2_press_pa_test},
+    {gc_cmd_s5, gc_dev_apogee_SP212_solar_irr_test},
+    {gc_cmd_s6, gc_dev_batt_test},
+    {gc_cmd_s7, gc_dev_spanel_test},
 };
 
-struct gc_board{
-    void (*setup)(struct gc_board* b);
-    void (*post)(void);
-    void (*sample)(struct gc_board* b);
-    void (*run_cmd)(struct gc_board* b);
-    void (*print_build_opts)(void);
-    void (*tx)(struct gc_board* b);
-    int (*ready_tx)(struct gc_board* b);
-    int (*ready_sample)(struct gc_board* b);
-    int (*ready_run_cmd)(struct gc_board* b);
-
-    int (*ready_heartbeat_tx)(struct gc_board* b);
-    void (*heartbeat_tx)(struct gc_board* b);
-
-    unsigned long prev_sample_ms;
-    unsigned long prev_heartbeat_ms;
-    int sample_count;
-    uint16_t node_addr;
-    struct gc_packet data_packet;
+static void gc_cmd_sensors(void){
+    Serial.println(F("\nSensor Sampling Menu"));
+    console_help(gc_cmds + 1, sizeof(gc_cmds) / sizeof(gc_cmds[0]) - 1);
+}
+
+struct gc_traits{
+    typedef struct gc_packet packet_t;
+
+    static const uint16_t schema = _SCHEMA_GC_;
+    static const int8_t pin_sen_en = _PIN_SEN_EN;
+    static const uint16_t sen_warmup_ms =
+        sen_power_max(_GC_DEV_HIH6131_WARMUP_MS_,
+        sen_power_max(_GC_DEV_MPL115A2_WARMUP_MS_, _GC_DEV_APOGEE_SP212_WARMUP_MS_));
+    static const uint8_t packet_len = SCHEMA_LEN(SCHEMA_GC_FIELDS);
+
+    static void print_build_opts(void){
+        Serial.println(F("Gen: cranberry"));
+    }
+
+    static void open(void){
+        gc_dev_xbee_open();
+        gc_dev_ads1115_open();
+        gc_dev_apogee_SP212_open();
+        gc_dev_batt_open();
+        gc_dev_spanel_open();
+        gc_dev_eeprom_naddr_open();
+        gc_dev_honeywell_HIH6131_open();
+        gc_dev_adafruit_MPL115A2_open();
+    }
+
+    static void post(void){
+        gc_dev_eeprom_naddr_test();
+        gc_dev_honeywell_HIH6131_temp_centik_test();
+        gc_dev_honeywell_HIH6131_humidity_pct_test();
+        gc_dev_adafruit_MPL115A2_press_pa_test();
+        gc_dev_apogee_SP212_solar_irr_test();
+        gc_dev_batt_test();
+        gc_dev_spanel_test();
+    }
+
+    // Called when the sensor rail comes back on. None of the
+    // drivers keep state in the devices.
+    static void sen_power_up(void){}
+
+    static void sample_start(void){
+        gc_dev_honeywell_HIH6131_start();
+        gc_dev_adafruit_MPL115A2_start();
+    }
+
+    static void sample(packet_t* data_packet){
+        // The ADS1115 channels are converted one after another
+        // while the HIH6131 measurement is running
+        data_packet->batt_mv             = PROF_CALL(PROF_READ_BATT, gc_dev_batt_read());
+        data_packet->panel_mv            = PROF_CALL(PROF_READ_SPANEL, gc_dev_spanel_read());
+        data_packet->mpl115a2t1_press_pa = PROF_CALL(PROF_READ_PRESS, gc_dev_adafruit_MPL115A2_press_pa_read());
+        data_packet->hih6131_temp_centik = PROF_CALL(PROF_READ_TEMP, gc_dev_honeywell_HIH6131_temp_centik_read());
+        data_packet->hih6131_humidity_pct= PROF_CALL(PROF_READ_HUMIDITY, gc_dev_honeywell_HIH6131_humidity_pct_read());
+    }
+
+    // Wire layout of packet_t, see schema.h
+    static void write(frame_writer* w, const packet_t* p){
+        SCHEMA_WRITE(SCHEMA_GC_FIELDS)
+    }
+
+    static void write_delta(frame_writer* w, const packet_t* p, const packet_t* prev){
+        SCHEMA_DELTA(SCHEMA_GC_DATA)
+    }
+
+    // The irradiance is sampled every _BOARD_IRR_PERIOD_MS_ in the
+    // background, the packet carries the summary of the window
+    static uint16_t irr_read(void){
+        return PROF_CALL(PROF_READ_IRR, gc_dev_apogee_SP212_solar_irr_read());
+    }
+
+    static void irr_summary(packet_t* data_packet, const window_stats* irr){
+        data_packet->apogee_w_m2         = irr->mean();
+        data_packet->apogee_min_w_m2     = irr->lo;
+        data_packet->apogee_max_w_m2     = irr->hi;
+        data_packet->apogee_var          = irr->variance();
+    }
+
+    // Report-by-exception deadbands: a sample is only sent if a
+    // field moved more than this since the last reported sample
+    static uint8_t changed(const packet_t* a, const packet_t* b){
+        return board_moved(a->batt_mv, b->batt_mv, 20) ||
+               board_moved(a->panel_mv, b->panel_mv, 100) ||
+               board_moved(a->apogee_w_m2, b->apogee_w_m2, 5) ||
+               board_moved(a->hih6131_temp_centik, b->hih6131_temp_centik, 20) ||
+               board_moved(a->hih6131_humidity_pct, b->hih6131_humidity_pct, 1) ||
+               board_moved(a->mpl115a2t1_press_pa, b->mpl115a2t1_press_pa, 20);
+    }
+
+    static uint16_t naddr_read(void){
+        return gc_dev_eeprom_naddr_read();
+    }
+
+    static uint16_t batt_read(void){
+        return gc_dev_batt_read();
+    }
+
+    static void xbee_write(uint8_t* data, int data_len){
+        gc_dev_xbee_write(data, data_len);
+    }
+
+    static void xbee_write_once(uint8_t* data, int data_len){
+        gc_dev_xbee_write(data, data_len);
+    }
+
+    static void xbee_poll(void){
+        gc_dev_xbee_poll();
+    }
+
+    // The XBee sleep pins are not wired on this board, the radio
+    // is always on. Stay awake a while after a transmit for the reply.
+    static uint8_t xbee_awake(void){
+        return gc_dev_xbee_awake();
+    }
+
+    static void print_cmd_help(void){
+        console_help(gc_cmds, 1);
+    }
+
+    static uint8_t run_cmd(const char* line){
+        return console_run(line, gc_cmds, sizeof(gc_cmds) / sizeof(gc_cmds[0]));
+    }
 };
 
-void gc_board_init(struct gc_board*);
+typedef board_core<gc_traits> gc_board;
 
 #endif
@@ -2,16 +2,30 @@
 #include "Adafruit_MPL115A2.h"
 
 static Adafruit_MPL115A2 mpl115a2;
+static struct sched_conv mpl115a2_conv;
 
 void gc_dev_adafruit_MPL115A2_open(void){
     mpl115a2.begin();
 }
 
+void gc_dev_adafruit_MPL115A2_start(void){
+    #ifndef SEN_STUB
+    mpl115a2.startConversion();
+    #endif
+    sched_conv_start(&mpl115a2_conv, MPL115A2_CONVERSIONDELAY);
+}
+
 uint32_t gc_dev_adafruit_MPL115A2_press_pa_read(void){
     uint32_t value = 100000;
+    int16_t temp;
+
+    if(!mpl115a2_conv.pending){
+        gc_dev_adafruit_MPL115A2_start();
+    }
+    sched_conv_wait(&mpl115a2_conv);
 
     #ifndef SEN_STUB
-    value = mpl115a2.getPressure() * 1000;
+    mpl115a2.readPTFixed(&value, &temp);
     #endif
 
     return value;
@@ -1,8 +1,15 @@
 #include <Arduino.h>
+#include "../sched.h"
+
+// Power-on to first conversion, on the switched sensor rail. The
+// coefficients are read once by open() and kept in RAM, so
+// nothing is lost when the rail is cut.
+#define _GC_DEV_MPL115A2_WARMUP_MS_ 5
 
 #ifndef GC_DEV_MPL115A2_H
 #define GC_DEV_MPL115A2_H
 void gc_dev_adafruit_MPL115A2_open(void);
+void gc_dev_adafruit_MPL115A2_start(void);
 uint32_t gc_dev_adafruit_MPL115A2_press_pa_read(void);
 void gc_dev_adafruit_MPL115A2_press_pa_test(void);
 #endif
@@ -0,0 +1,7 @@
+#include "gc_dev_ads1115.h"
+
+Adafruit_ADS1115 gc_ads1115;
+
+void gc_dev_ads1115_open(void){
+    gc_ads1115.begin();
+}
@@ -0,0 +1,10 @@
+#include <Adafruit_ADS1015.h>
+#include <Wire.h>
+
+#ifndef GC_DEV_ADS1115_H
+#define GC_DEV_ADS1115_H
+// One ADC converts the battery, panel and solar irradiance channels
+extern Adafruit_ADS1115 gc_ads1115;
+
+void gc_dev_ads1115_open(void);
+#endif
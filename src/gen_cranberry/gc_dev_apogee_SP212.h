@@ -1,5 +1,8 @@
-#include <Adafruit_ADS1015.h>
-#include <Wire.h>
+#include "gc_dev_ads1115.h"
+
+// Response time of the amplified sensor on the switched sensor
+// rail. The ADS1115 is always powered, it reads the battery too.
+#define _GC_DEV_APOGEE_SP212_WARMUP_MS_ 1
 
 #ifndef GC_DEV_SOLAR_H
 #define GC_DEV_SOLAR_H
@@ -1,10 +1,14 @@
 #include "gc_dev_batt.h"
+#include "../fixed_point.h"
 
-static Adafruit_ADS1115 adc;
+// ADS1115 counts to mV, including the 1:2 voltage divider
+#define _GC_BATT_NUM_ (2UL*_FIXED_ADS1115_UV_)
+#define _GC_BATT_DEN_ 1000
+static constexpr uint32_t gc_batt_q16 = fixed_q16(_GC_BATT_NUM_, _GC_BATT_DEN_);
+static_assert(fixed_q16_check(0, _FIXED_ADS1115_MAX_, _GC_BATT_NUM_, _GC_BATT_DEN_),
+              "gc_dev_batt: fixed point scale off by more than one LSB");
 
-void gc_dev_batt_open(void){
-    adc.begin();
-}
+void gc_dev_batt_open(void){}
 
 uint16_t gc_dev_batt_read(void){
     uint16_t value = 4000;
@@ -16,7 +20,7 @@ uint16_t gc_dev_batt_read(void){
     Note: the cranberry v3.5.0 schematic is incorrect because the values for R21 and
     R20 are described with values of 150k and 51k respectively. In reality, R21 and
     R20 are equal to each other (the values are still unkown as of 2016-10-24). */
-    value = 2.0*((float)adc.readADC_SingleEnded(2)*188.0)/(1000.0);
+    value = fixed_mul_q16(gc_ads1115.readADC_SingleEnded_Idle(2), gc_batt_q16);
     #endif
 
     return value;
@@ -1,19 +1,61 @@
 #include "gc_dev_honeywell_HIH6131.h"
 #include "HIH613x.h"
+#include "../fixed_point.h"
+
+// Counts to percent humidity and to cK above -40 C
+#define _GC_HIH6131_PCT_NUM_ 100
+#define _GC_HIH6131_CENTIK_NUM_ 16500
+#define _GC_HIH6131_CENTIK_MIN_ 23315
+static constexpr uint32_t gc_hih6131_pct_q16 = fixed_q16(_GC_HIH6131_PCT_NUM_, _FIXED_HIH613X_MAX_);
+static constexpr uint32_t gc_hih6131_centik_q16 = fixed_q16(_GC_HIH6131_CENTIK_NUM_, _FIXED_HIH613X_MAX_);
+static_assert(fixed_q16_check(0, _FIXED_HIH613X_MAX_, _GC_HIH6131_PCT_NUM_, _FIXED_HIH613X_MAX_),
+              "gc_dev_honeywell_HIH6131: humidity scale off by more than one LSB");
+static_assert(fixed_q16_check(0, _FIXED_HIH613X_MAX_, _GC_HIH6131_CENTIK_NUM_, _FIXED_HIH613X_MAX_),
+              "gc_dev_honeywell_HIH6131: temperature scale off by more than one LSB");
 
 static HIH613x hih6131(0x27);
+static struct sched_conv hih6131_conv;
+
+// Temperature and humidity come from the same measurement. It is
+// fetched once and kept until the next measurement is started.
+static uint8_t hih6131_fresh = 0;
 
 void gc_dev_honeywell_HIH6131_open(void){
     Wire.begin(9600);
 }
 
+void gc_dev_honeywell_HIH6131_start(void){
+    #ifndef SEN_STUB
+    hih6131.measurementRequest();
+    #endif
+    sched_conv_start(&hih6131_conv, HIH613X_MEASUREMENT_MS);
+    hih6131_fresh = 0;
+}
+
+static void gc_dev_honeywell_HIH6131_collect(void){
+    if(hih6131_fresh){
+        return;
+    }
+    if(!hih6131_conv.pending){
+        gc_dev_honeywell_HIH6131_start();
+    }
+    sched_conv_wait(&hih6131_conv);
+
+    #ifndef SEN_STUB
+    hih6131.dataFetch();
+    #endif
+
+    hih6131_fresh = 1;
+}
+
 
 uint16_t gc_dev_honeywell_HIH6131_temp_centik_read(void){
     int16_t value = 30000;
 
+    gc_dev_honeywell_HIH6131_collect();
+
     #ifndef SEN_STUB
-    hih6131.update();
-    value = (float)hih6131.getTemperature()*100.0 + 27315.0;
+    value = fixed_mul_q16(hih6131.getTemperatureRaw(), gc_hih6131_centik_q16) + _GC_HIH6131_CENTIK_MIN_;
     #endif
 
     return value;
@@ -22,9 +64,10 @@ uint16_t gc_dev_honeywell_HIH6131_temp_centik_read(void){
 uint16_t gc_dev_honeywell_HIH6131_humidity_pct_read(void){
     uint16_t value = 60;
 
+    gc_dev_honeywell_HIH6131_collect();
+
     #ifndef SEN_STUB
-    hih6131.update();
-    value = hih6131.getHumidity();
+    value = fixed_mul_q16(hih6131.getHumidityRaw(), gc_hih6131_pct_q16);
     #endif
 
     return value;
@@ -32,6 +75,7 @@ uint16_t gc_dev_honeywell_HIH6131_humidity_pct_read(void){
 
 void gc_dev_honeywell_HIH6131_temp_centik_test(void){
     Serial.println(F("[P] Check hih6131_temp_centik value"));
+    gc_dev_honeywell_HIH6131_start();
     int hih6131_temp_centik_val = gc_dev_honeywell_HIH6131_temp_centik_read();
 
     Serial.print(F("[P] hih6131_temp_centik value: "));
@@ -45,6 +89,7 @@ void gc_dev_honeywell_HIH6131_temp_centik_test(void){
 
 void gc_dev_honeywell_HIH6131_humidity_pct_test(void){
     Serial.println(F("[P] Check hih6131_humidity value"));
+    gc_dev_honeywell_HIH6131_start();
     int hih6131_humidity_pct_val = gc_dev_honeywell_HIH6131_humidity_pct_read();
 
     Serial.print(F("[P] hih6131_humidity_pct value: "));
@@ -1,10 +1,15 @@
 #include <Arduino.h>
+#include "../sched.h"
 
 //#define _PIN_GC_HIH6131_ AX
 
+// Power-on to first measurement, on the switched sensor rail
+#define _GC_DEV_HIH6131_WARMUP_MS_ 60
+
 #ifndef GC_DEV_HIH6131_H
 #define GC_DEV_HIH6131_H
 void gc_dev_honeywell_HIH6131_open(void);
+void gc_dev_honeywell_HIH6131_start(void);
 uint16_t gc_dev_honeywell_HIH6131_temp_centik_read(void);
 uint16_t gc_dev_honeywell_HIH6131_humidity_pct_read(void);
 void gc_dev_honeywell_HIH6131_temp_centik_test(void);
@@ -1,16 +1,19 @@
 #include "gc_dev_spanel.h"
+#include "../fixed_point.h"
 
-static Adafruit_ADS1115 adc;
+#define _GC_SPANEL_NUM_ _FIXED_ADS1115_UV_
+#define _GC_SPANEL_DEN_ 1000
+static constexpr uint32_t gc_spanel_q16 = fixed_q16(_GC_SPANEL_NUM_, _GC_SPANEL_DEN_);
+static_assert(fixed_q16_check(0, _FIXED_ADS1115_MAX_, _GC_SPANEL_NUM_, _GC_SPANEL_DEN_),
+              "gc_dev_spanel: fixed point scale off by more than one LSB");
 
-void gc_dev_spanel_open(void){
-    adc.begin();
-}
+void gc_dev_spanel_open(void){}
 
 uint16_t gc_dev_spanel_read(void){
   uint16_t value = 6000;
 
   #ifndef SEN_STUB
-  value = ((float)adc.readADC_SingleEnded(3)*188.0)/(1000.0);
+  value = fixed_mul_q16(gc_ads1115.readADC_SingleEnded_Idle(3), gc_spanel_q16);
   #endif
 
   return value;
@@ -1,5 +1,4 @@
-#include <Adafruit_ADS1015.h>
-#include <Wire.h>
+#include "gc_dev_ads1115.h"
 
 #ifndef GC_DEV_SPANEL
 #define GC_DEV_SPANEL
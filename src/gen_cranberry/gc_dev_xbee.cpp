@@ -1,28 +1,60 @@
 #include "gc_dev_xbee.h"
 
+static XBee xbee = XBee();
+static uint8_t xbee_rx_window = 0;
+static unsigned long xbee_tx_ms = 0;    // Time of the last transmit
+
 void gc_dev_xbee_open(void)
 {
-    soft_serial.begin(9600);
-    xbee.begin(soft_serial);
+    xbee_serial.begin(_GC_DEV_XBEE_BAUD_, _PIN_GC_XBEE_RX_, _PIN_GC_XBEE_TX_);
+    xbee.begin(xbee_serial);
+    xbee_rx_open();
 
     /* Enable the XBee voltage regulator pin to power XBee */
     digitalWrite(3, HIGH);
 }
 
-int gc_dev_xbee_avail(void)
+void gc_dev_xbee_write(uint8_t *data, int data_len)
 {
-    return Serial.available();
+    XBeeAddress64 addr64 = XBeeAddress64(0, 0);
+    ZBTxRequest zbtx = ZBTxRequest(addr64, data, data_len);
+
+    xbee.send(zbtx);
+    xbee_tx_ms = millis();
+    xbee_rx_window = 1;
 }
 
-int gc_dev_xbee_read(void)
+void gc_dev_xbee_poll(void)
 {
-    return Serial.read();
+    struct xbee_rx_frame* f;
+
+    while((f = xbee_rx_peek()) != NULL){
+        switch(f->data[_XBEE_RX_API_ID_]){
+            case MODEM_STATUS_RESPONSE:
+                Serial.print(F("XBee modem status: "));
+                Serial.println(f->data[_XBEE_RX_MODEM_STATUS_], HEX);
+                break;
+            case ZB_RX_RESPONSE:
+                if(time_sync_rx(&f->data[_XBEE_RX_ZB_DATA_],
+                                f->len - _XBEE_RX_ZB_DATA_, f->ms)){
+                    break;
+                }
+                console_rx(&f->data[_XBEE_RX_ZB_DATA_], f->len - _XBEE_RX_ZB_DATA_);
+                break;
+        }
+        xbee_rx_pop();
+    }
+
+    if(xbee_rx_dropped()){
+        Serial.println(F("XBee RX frame dropped"));
+    }
 }
 
-void gc_dev_xbee_write(uint8_t *data, int data_len)
+uint8_t gc_dev_xbee_awake(void)
 {
-    XBeeAddress64 addr64 = XBeeAddress64(0, 0);
-    ZBTxRequest zbtx = ZBTxRequest(addr64, data, data_len);
-
-    xbee.send(zbtx);
+    if(xbee_rx_window && millis() - xbee_tx_ms < _GC_DEV_XBEE_RX_WINDOW_MS_){
+        return 1;
+    }
+    xbee_rx_window = 0;
+    return 0;
 }
@@ -2,7 +2,8 @@
  *
  * File: gd_board.h 
  *
- * Contains struct for Dragonfruit packet, heartbeat, and board 
+ * Contains struct for Dragonfruit packet and the board traits
+ * used by board_core
  *
  ******************************/
 
@@ -12,8 +13,11 @@
 #include "gd_dev_batt.h"
 #include "gd_dev_spanel.h"
 #include "gd_dev_eeprom_naddr.h"
-#include "gd_dev_adafruit_MPL115A2_temp.h"
-#include "gd_dev_adafruit_MPL115A2_press.h"
+#include "gd_dev_adafruit_MPL115A2.h"
+#include "../prof.h"
+#include "../sen_power.h"
+#include "../schema.h"
+#include "../board_core.h"
 #include <Arduino.h>
 
 #define _PIN_SEN_EN_ 4
@@ -22,44 +26,126 @@
 #define GD_BOARD_H
 
 struct gd_packet{
-  uint16_t schema;
-  uint16_t node_addr;         // Address of Arduino
-  uint32_t uptime_ms;         // Time since start of program
-  uint16_t batt_mv;           // Battery Voltage (in milli volts)
-  uint16_t panel_mv;          // Panel Voltage (in milli volts)
-  uint32_t apogee_sp215;      // Solar radiance
-  uint16_t mpl115a2t1_temp;    // Temperature (centiKelvin)
-  uint16_t hih6131_humidity_pct;  // Humidity (percentage)
-  uint32_t mpl115a2t1_press;  // Pressure (Pa)
+    SCHEMA_STRUCT(SCHEMA_GD_FIELDS)
 };
 
-struct gd_heartbeat_packet{
-    uint16_t schema;
-    uint16_t node_addr;             // Address of Arduino
-    uint32_t uptime_ms;             // Time since start of program
-    uint16_t batt_mv;               // Battery Voltage (in milli volts)
-};
+struct gd_traits{
+    typedef struct gd_packet packet_t;
+
+    static const uint16_t schema = _SCHEMA_GD_;
+    static const int8_t pin_sen_en = _PIN_SEN_EN_;
+    static const uint16_t sen_warmup_ms =
+        sen_power_max(_GD_DEV_HIH6131_WARMUP_MS_,
+        sen_power_max(_GD_DEV_MPL115A2_WARMUP_MS_, _GD_DEV_APOGEE_SP215_WARMUP_MS_));
+    static const uint8_t packet_len = SCHEMA_LEN(SCHEMA_GD_FIELDS);
+
+    static void print_build_opts(void){
+        Serial.println(F("Gen: dragonfruit"));
+    }
+
+    static void open(void){
+        adc_service_open();
+        gd_dev_xbee_open();
+        gd_dev_honeywell_HIH6131_open();
+        gd_dev_adafruit_MPL115A2_open();
+        gd_dev_batt_open();
+        gd_dev_spanel_open();
+        gd_dev_eeprom_naddr_open();
+        gd_dev_apogee_sp215_open();
+    }
+
+    static void post(void){
+        gd_dev_eeprom_naddr_test();
+        gd_dev_honeywell_HIH6131_test();
+        gd_dev_adafruit_MPL115A2_temp_test();
+        gd_dev_adafruit_MPL115A2_press_test();
+        gd_dev_apogee_sp215_test();
+        gd_dev_batt_test();
+        gd_dev_spanel_test();
+    }
+
+    // Called when the sensor rail comes back on
+    static void sen_power_up(void){
+        gd_dev_apogee_sp215_power_up();
+    }
+
+    static void sample_start(void){
+        adc_service_start();
+        gd_dev_honeywell_HIH6131_start();
+        gd_dev_adafruit_MPL115A2_start();
+    }
+
+    static void sample(packet_t* data_packet){
+        data_packet->batt_mv             = PROF_CALL(PROF_READ_BATT, gd_dev_batt_read());
+        data_packet->panel_mv            = PROF_CALL(PROF_READ_SPANEL, gd_dev_spanel_read());
+        data_packet->mpl115a2t1_press    = PROF_CALL(PROF_READ_PRESS, gd_dev_adafruit_MPL115A2_press_read());
+        data_packet->mpl115a2t1_temp     = PROF_CALL(PROF_READ_TEMP, gd_dev_adafruit_MPL115A2_temp_read());
+        data_packet->hih6131_humidity_pct= PROF_CALL(PROF_READ_HUMIDITY, gd_dev_honeywell_HIH6131_read());
+    }
+
+    // Wire layout of packet_t, see schema.h
+    static void write(frame_writer* w, const packet_t* p){
+        SCHEMA_WRITE(SCHEMA_GD_FIELDS)
+    }
+
+    static void write_delta(frame_writer* w, const packet_t* p, const packet_t* prev){
+        SCHEMA_DELTA(SCHEMA_GD_DATA)
+    }
+
+    // The irradiance is sampled every _BOARD_IRR_PERIOD_MS_ in the
+    // background, the packet carries the summary of the window
+    static uint16_t irr_read(void){
+        // min() is a macro, read once
+        uint32_t irr = PROF_CALL(PROF_READ_IRR, gd_dev_apogee_sp215_read());
+
+        return min(irr, 0xFFFFUL);
+    }
+
+    static void irr_summary(packet_t* data_packet, const window_stats* irr){
+        data_packet->apogee_sp215        = irr->mean();
+        data_packet->apogee_sp215_min    = irr->lo;
+        data_packet->apogee_sp215_max    = irr->hi;
+        data_packet->apogee_sp215_var    = irr->variance();
+    }
+
+    // Report-by-exception deadbands: a sample is only sent if a
+    // field moved more than this since the last reported sample
+    static uint8_t changed(const packet_t* a, const packet_t* b){
+        return board_moved(a->batt_mv, b->batt_mv, 20) ||
+               board_moved(a->panel_mv, b->panel_mv, 100) ||
+               board_moved(a->apogee_sp215, b->apogee_sp215, 5) ||
+               board_moved(a->mpl115a2t1_temp, b->mpl115a2t1_temp, 20) ||
+               board_moved(a->hih6131_humidity_pct, b->hih6131_humidity_pct, 1) ||
+               board_moved(a->mpl115a2t1_press, b->mpl115a2t1_press, 20);
+    }
+
+    static uint16_t naddr_read(void){
+        return gd_dev_eeprom_naddr_read();
+    }
+
+    static uint16_t batt_read(void){
+        return gd_dev_batt_read();
+    }
+
+    static void xbee_write(uint8_t* data, int data_len){
+        gd_dev_xbee_write(data, data_len);
+    }
+
+    static void xbee_write_once(uint8_t* data, int data_len){
+        gd_dev_xbee_write_once(data, data_len);
+    }
+
+    static void xbee_poll(void){
+        gd_dev_xbee_poll();
+    }
+
+    static uint8_t xbee_awake(void){
+        return gd_dev_xbee_awake();
+    }
 
-struct gd_board{
-    void (*setup)(struct gd_board* b);
-    void (*post)(void);
-    void (*sample)(struct gd_board* b);
-    void (*run_cmd)(struct gd_board* b);
-    void (*print_build_opts)(void);
-    void (*tx)(struct gd_board* b);
-    int (*ready_tx)(struct gd_board* b);
-    int (*ready_sample)(struct gd_board* b);
-    int (*ready_run_cmd)(struct gd_board* b);
-
-    int (*ready_heartbeat_tx)(struct gd_board* b);
-    void (*heartbeat_tx)(struct gd_board* b);
-
-    unsigned long prev_sample_ms;
-    unsigned long prev_heartbeat_ms;
-    int sample_count;
-    uint16_t node_addr;
-    struct gd_packet data_packet;
+    static void print_cmd_help(void){}
+    static uint8_t run_cmd(const char* line){ return 0; }
 };
 
-void gd_board_init(struct gd_board*);
+typedef board_core<gd_traits> gd_board;
 #endif
@@ -0,0 +1,153 @@
+/*******************************
+ *
+ * File: gd_dev_adafruit_MPL115A2.cpp
+ *
+ * This module is a driver for the MPL115A2 pressure sensor 
+ * that measures pressure in Pa and temperature in cK. Technically
+ * this is not an Adafruit sensor - Adafruit creates the breakout
+ * board for this sensor that is actually manufactured by Freescale.
+ *
+ * One conversion returns both pressure and temperature, so the
+ * result is cached and serves both packet fields until the next
+ * conversion is started.
+ * 
+ * Product page: http://www.nxp.com/products/sensors/pressure-sensors/barometric-pressure-15-to-115-kpa/50-to-115kpa-absolute-digital-pressure-sensor:MPL115A
+ * Datasheet: http://www.nxp.com/assets/documents/data/en/data-sheets/MPL115A2.pdf
+ *
+ ******************************/
+
+#include "gd_dev_adafruit_MPL115A2.h"
+
+static Adafruit_MPL115A2 mpl115a2t1;
+static struct sched_conv mpl115a2t1_conv;
+static uint8_t mpl115a2t1_fresh = 0;
+static uint32_t mpl115a2t1_press_pa = 0;
+static int16_t mpl115a2t1_temp_centic = 0;
+
+/******************************
+ * 
+ * Name:        gd_dev_adafruit_MPL115A2_open
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Initialize pressure sensor and load its
+ *              coefficients
+ * 
+ ******************************/
+void gd_dev_adafruit_MPL115A2_open(void){
+    mpl115a2t1.begin();
+}
+
+/******************************
+ * 
+ * Name:        gd_dev_adafruit_MPL115A2_start
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Start a pressure and temperature conversion.
+ *              Drops the cached result.
+ * 
+ ******************************/
+void gd_dev_adafruit_MPL115A2_start(void){
+    #ifndef SEN_STUB
+    mpl115a2t1.startConversion();
+    #endif
+    sched_conv_start(&mpl115a2t1_conv, MPL115A2_CONVERSIONDELAY);
+    mpl115a2t1_fresh = 0;
+}
+
+/******************************
+ * 
+ * Name:        gd_dev_adafruit_MPL115A2_collect
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Read the conversion result into the cache
+ *              unless it is already there. Starts a
+ *              conversion first if none is pending.
+ * 
+ ******************************/
+static void gd_dev_adafruit_MPL115A2_collect(void){
+    if(mpl115a2t1_fresh){
+        return;
+    }
+    if(!mpl115a2t1_conv.pending){
+        gd_dev_adafruit_MPL115A2_start();
+    }
+    sched_conv_wait(&mpl115a2t1_conv);
+    #ifndef SEN_STUB
+    mpl115a2t1.readPTFixed(&mpl115a2t1_press_pa, &mpl115a2t1_temp_centic);
+    #endif
+    mpl115a2t1_fresh = 1;
+}
+
+/******************************
+ * 
+ * Name:        gd_dev_adafruit_MPL115A2_press_read
+ * Returns:     Pressure value in Pa 
+ * Parameter:   Nothing
+ * Description: Reads pressure sensor 
+ * 
+ ******************************/
+uint32_t gd_dev_adafruit_MPL115A2_press_read(void){
+  uint32_t value = 88;
+  gd_dev_adafruit_MPL115A2_collect();
+  #ifndef SEN_STUB
+  value = mpl115a2t1_press_pa;
+  #endif
+  return value;
+}
+
+/******************************
+ * 
+ * Name:        gd_dev_adafruit_MPL115A2_temp_read
+ * Returns:     Temperature value in centiKelvin (cK) 
+ * Parameter:   Nothing
+ * Description: Reads temperature sensor 
+ * 
+ ******************************/
+uint16_t gd_dev_adafruit_MPL115A2_temp_read(void){
+  uint16_t value = 0;
+  gd_dev_adafruit_MPL115A2_collect();
+  #ifndef SEN_STUB
+  value = mpl115a2t1_temp_centic + 27315; //Convert to centiKelvin (cK)
+  #endif
+  return value;
+}
+
+/******************************
+ * 
+ * Name:        gd_dev_adafruit_MPL115A2_press_test
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Check pressure sensor for POST
+ * 
+ ******************************/
+void gd_dev_adafruit_MPL115A2_press_test(void){
+    gd_dev_adafruit_MPL115A2_start();
+    uint32_t mpl115a2_press = gd_dev_adafruit_MPL115A2_press_read();
+    Serial.print(F("[P] mpl115a2 pressure: "));
+    Serial.print(mpl115a2_press);
+    Serial.println(F(" Pa"));
+
+    if(mpl115a2_press < 0){
+        Serial.println(F("[P] Error: mpl115a2 pressure out of range"));
+    }
+}
+
+/******************************
+ * 
+ * Name:        gd_dev_adafruit_MPL115A2_temp_test
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Check temperature sensor for POST
+ * 
+ ******************************/
+void gd_dev_adafruit_MPL115A2_temp_test(void){
+    gd_dev_adafruit_MPL115A2_start();
+    uint16_t mpl115a2_temp_val = gd_dev_adafruit_MPL115A2_temp_read();
+    Serial.print(F("[P] mpl115a2 temp: "));
+    Serial.print(mpl115a2_temp_val);
+    Serial.println(F(" cK"));
+    
+    if(mpl115a2_temp_val < 0){
+        Serial.println(F("[P] \tError: mpl115a2 temp out of range"));
+    }
+}
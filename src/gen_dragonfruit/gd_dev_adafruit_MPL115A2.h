@@ -0,0 +1,24 @@
+/*******************************
+ *
+ * File: gd_dev_adafruit_MPL115A2.h 
+ *
+ * Contains prototypes for pressure and temperature sensor functions
+ *
+ ******************************/
+
+#include "Adafruit_MPL115A2.h"
+#include "../sched.h"
+
+// Start-up time on the switched sensor rail. open() loads the
+// calibration coefficients into RAM, a power cycle loses nothing.
+#define _GD_DEV_MPL115A2_WARMUP_MS_ 5
+
+#ifndef _GD_ADAFRUIT_MPL115A2_H
+#define _GD_ADAFRUIT_MPL115A2_H
+void gd_dev_adafruit_MPL115A2_open(void);
+void gd_dev_adafruit_MPL115A2_start(void);
+uint32_t gd_dev_adafruit_MPL115A2_press_read(void);
+uint16_t gd_dev_adafruit_MPL115A2_temp_read(void);
+void gd_dev_adafruit_MPL115A2_press_test(void);
+void gd_dev_adafruit_MPL115A2_temp_test(void);
+#endif
@@ -1,15 +0,0 @@
-/*******************************
- *
- * File: gd_dev_adafruit_MPL115A2_press.h 
- *
- * Contains prototypes for pressure sensor functions
- *
- ******************************/
-
-#include "Adafruit_MPL115A2.h"
-
-#ifndef _GD_ADAFRUIT_MPL115A2_PRESS_H
-#define _GD_ADAFRUIT_MPL115A2_PRESS_H
-void gd_dev_adafruit_MPL115A2_press_open(void);
-uint32_t gd_dev_adafruit_MPL115A2_press_read(void);
-#endif
@@ -15,6 +15,14 @@
  * ****************************/
 
 #include "gd_dev_apogee_sp215.h"
+#include "../fixed_point.h"
+
+// ADS1100 counts to mV, 0x7FFF is full scale at the 5 V reference
+#define _GD_APOGEE_SP215_NUM_ _FIXED_ADC_VREF_MV_
+#define _GD_APOGEE_SP215_DEN_ 0x7FFF
+static constexpr uint32_t gd_apogee_sp215_q16 = fixed_q16(_GD_APOGEE_SP215_NUM_, _GD_APOGEE_SP215_DEN_);
+static_assert(fixed_q16_check(0, 0xFFFF, _GD_APOGEE_SP215_NUM_, _GD_APOGEE_SP215_DEN_),
+              "gd_dev_apogee_sp215: fixed point scale off by more than one LSB");
 
 /******************************
  * 
@@ -29,6 +37,20 @@ void gd_dev_apogee_sp215_open(void){
     /* Initiate Wire library and join I2C bus as slave */
     Wire.begin();
 
+    gd_dev_apogee_sp215_power_up();
+}
+
+/******************************
+ * 
+ * Name:        gd_dev_apogee_sp215_power_up
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Configure the ADS1100, which forgets its
+ *              configuration whenever the sensor rail is cut
+ * 
+ ******************************/
+void gd_dev_apogee_sp215_power_up(void){
+
     /* Begin transmission to the I2C slave device with the given address */
     Wire.beginTransmission(_DEV_ADDR_GD_ADS1100_);
 
@@ -71,7 +93,26 @@ uint32_t gd_dev_apogee_sp215_read(void){
     /* Analog to digital conversion with 16-bit resolution. Multiply by 5V
     reference voltage then divide by 0x7FFF to convert the 16-bit ADC reading
     to voltage. 0x7FFF is the maximum positive value of the reading. */
-    value = (value*5000.0)/(0x7FFF);
+    value = fixed_mul_q16(value, gd_apogee_sp215_q16);
     #endif
     return value;
 }
+
+/******************************
+ * 
+ * Name:        gd_dev_apogee_sp215_test
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Check solar irradiance sensor for POST
+ * 
+ ******************************/
+void gd_dev_apogee_sp215_test(void){
+    uint32_t apogee_sp215_val = gd_dev_apogee_sp215_read();
+    Serial.print(F("[P] apogee_sp215 solar irr value: "));
+    Serial.print(apogee_sp215_val);
+    Serial.println(F(" mV"));
+
+    if(apogee_sp215_val < 0){
+        Serial.println(F("[P] \tError: apogee solar irr out of range"));
+    }
+}
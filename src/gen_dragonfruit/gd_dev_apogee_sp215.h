@@ -11,8 +11,15 @@
 
 #define _DEV_ADDR_GD_ADS1100_ 0x48
 
+// The SP215 and its ADS1100 are on the switched sensor rail. The
+// first continuous conversion at 8 SPS is ready 125 ms after
+// gd_dev_apogee_sp215_power_up().
+#define _GD_DEV_APOGEE_SP215_WARMUP_MS_ 130
+
 #ifndef GD_DEV_APOGEE_SP215_H
 #define GD_DEV_APOGEE_SP215_H
 void gd_dev_apogee_sp215_open(void);
+void gd_dev_apogee_sp215_power_up(void);
 uint32_t gd_dev_apogee_sp215_read(void);
+void gd_dev_apogee_sp215_test(void);
 #endif
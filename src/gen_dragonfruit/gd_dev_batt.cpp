@@ -7,6 +7,16 @@
  ******************************/
 
 #include "gd_dev_batt.h"
+#include "../fixed_point.h"
+
+// ADC counts to mV
+#define _GD_BATT_NUM_ _FIXED_ADC_VREF_MV_
+#define _GD_BATT_DEN_ _ADC_SERVICE_MAX_(_GD_BATT_ADC_BITS_)
+static constexpr uint32_t gd_batt_q16 = fixed_q16(_GD_BATT_NUM_, _GD_BATT_DEN_);
+static_assert(fixed_q16_check(0, _GD_BATT_DEN_, _GD_BATT_NUM_, _GD_BATT_DEN_),
+              "gd_dev_batt: fixed point scale off by more than one LSB");
+
+static uint8_t gd_batt_adc;
 
 /******************************
  * 
@@ -18,6 +28,7 @@
  ******************************/
 void gd_dev_batt_open(void){
     pinMode(_PIN_GD_BATT_, INPUT);
+    gd_batt_adc = adc_service_add(_PIN_GD_BATT_, _GD_BATT_ADC_BITS_);
 }
 
 /******************************
@@ -32,10 +43,29 @@ int gd_dev_batt_read(void){
     int value = 555;
 
     #ifndef SEN_STUB
-    // Function returns the battery reading as an integer in the range from 0 to 1023.
-    // Divide by 1023 to offset and then convert to mV.
-    value = analogRead(_PIN_GD_BATT_)*5000.0/1023;  
-    #endif                                         
+    // The ADC service returns the battery reading oversampled to
+    // 12 bits, 0 to 4092. Scale that to mV.
+    value = fixed_mul_q16(adc_service_read(gd_batt_adc), gd_batt_q16);
+    #endif
 
     return value;
 }
+
+/******************************
+ * 
+ * Name:        gd_dev_batt_test
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Check battery voltage for POST
+ * 
+ ******************************/
+void gd_dev_batt_test(void){
+    int batt_val = gd_dev_batt_read();
+    Serial.print(F("[P] batt value: "));
+    Serial.print(batt_val);
+    Serial.println(F(" mV"));
+
+    if(batt_val < 0){
+        Serial.println(F("[P] Error: batt out of range"));
+    }
+}
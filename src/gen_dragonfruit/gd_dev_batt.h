@@ -7,11 +7,15 @@
  ******************************/
 
 #include <Arduino.h>
+#include "../adc_service.h"
 
+// Oversampled to 12 bit
+#define _GD_BATT_ADC_BITS_ 2
 #define _PIN_GD_BATT_ A7
 
 #ifndef GD_DEV_BATT_H
 #define GD_DEV_BATT_H
 void gd_dev_batt_open(void);
 int gd_dev_batt_read(void);
+void gd_dev_batt_test(void);
 #endif
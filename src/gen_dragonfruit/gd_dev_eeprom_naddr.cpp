@@ -15,3 +15,16 @@ uint16_t gd_dev_eeprom_naddr_read(void){
     uint32_t node_addr = EEPROM.read(2) | (EEPROM.read(3)<<8);
     return node_addr;
 }
+
+/******************************
+ * 
+ * Name:        gd_dev_eeprom_naddr_test
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Print node address for POST
+ * 
+ ******************************/
+void gd_dev_eeprom_naddr_test(void){
+    Serial.print(F("[P] node addr: "));
+    Serial.println((int) gd_dev_eeprom_naddr_read());
+}
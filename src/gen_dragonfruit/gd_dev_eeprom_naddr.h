@@ -13,4 +13,5 @@
 #define GD_DEV_EEPROM_NADDR_H
 void gd_dev_eeprom_naddr_open(void);
 uint16_t gd_dev_eeprom_naddr_read(void);
+void gd_dev_eeprom_naddr_test(void);
 #endif
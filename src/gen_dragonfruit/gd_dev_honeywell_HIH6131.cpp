@@ -11,8 +11,16 @@
  ******************************/
 
 #include "gd_dev_honeywell_HIH6131.h"
+#include "../fixed_point.h"
+
+// Humidity counts to percent
+#define _GD_HIH6131_PCT_NUM_ 100
+static constexpr uint32_t gd_hih6131_pct_q16 = fixed_q16(_GD_HIH6131_PCT_NUM_, _FIXED_HIH613X_MAX_);
+static_assert(fixed_q16_check(0, _FIXED_HIH613X_MAX_, _GD_HIH6131_PCT_NUM_, _FIXED_HIH613X_MAX_),
+              "gd_dev_honeywell_HIH6131: fixed point scale off by more than one LSB");
 
 static HIH613x hih6131(_PIN_GD_HONEYWELL_HIH6131_);
+static struct sched_conv hih6131_conv;
 
 /******************************
  * 
@@ -27,20 +35,61 @@ void gd_dev_honeywell_HIH6131_open(void)
     Wire.begin(9600);
 }
 
+/******************************
+ * 
+ * Name:        gd_dev_honeywell_HIH6131_start
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Start a humidity measurement. The result is
+ *              collected by gd_dev_honeywell_HIH6131_read
+ * 
+ ******************************/
+void gd_dev_honeywell_HIH6131_start(void)
+{
+    #ifndef SEN_STUB
+    hih6131.measurementRequest();
+    #endif
+    sched_conv_start(&hih6131_conv, HIH613X_MEASUREMENT_MS);
+}
+
 /******************************
  * 
  * Name:        gd_dev_honeywell_HIH6131_read
  * Returns:     Humidity percentage
  * Parameter:   Nothing
- * Description: Read humidity sensor 
+ * Description: Read humidity sensor. Starts a measurement
+ *              first if none is pending.
  * 
  ******************************/
 int gd_dev_honeywell_HIH6131_read(void)
 {
     int value = 555;
+    if(!hih6131_conv.pending){
+        gd_dev_honeywell_HIH6131_start();
+    }
+    sched_conv_wait(&hih6131_conv);
     #ifndef SEN_STUB
-    hih6131.update();
-    value = hih6131.getHumidity();
+    hih6131.dataFetch();
+    value = fixed_mul_q16(hih6131.getHumidityRaw(), gd_hih6131_pct_q16);
     #endif
     return value;
 }
+
+/******************************
+ * 
+ * Name:        gd_dev_honeywell_HIH6131_test
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Check humidity sensor for POST
+ * 
+ ******************************/
+void gd_dev_honeywell_HIH6131_test(void){
+    int h1h6_val = gd_dev_honeywell_HIH6131_read();
+    Serial.print(F("[P] hih6 value: "));
+    Serial.print(h1h6_val);
+    Serial.println("\%");
+
+    if(h1h6_val < 0){
+        Serial.println(F("[P] \tError: Humidity out of range"));
+    }
+}
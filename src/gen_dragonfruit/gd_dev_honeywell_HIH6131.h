@@ -7,12 +7,18 @@
  ******************************/
 
 #include "HIH613x.h"
+#include "../sched.h"
 
 #define _PIN_GD_HONEYWELL_HIH6131_ 0x27
 
+// Start-up time on the switched sensor rail, no state to restore
+#define _GD_DEV_HIH6131_WARMUP_MS_ 60
+
 #ifndef _GD_HONEYWELL_HIH6131_H
 #define _GD_HONEYWELL_HIH6131_H
 
 void gd_dev_honeywell_HIH6131_open(void);
+void gd_dev_honeywell_HIH6131_start(void);
 int gd_dev_honeywell_HIH6131_read(void);
+void gd_dev_honeywell_HIH6131_test(void);
 #endif
@@ -10,6 +10,16 @@
  ******************************/
 
 #include "gd_dev_spanel.h"
+#include "../fixed_point.h"
+
+// ADC counts to mV, including the 1:2 voltage divider
+#define _GD_SPANEL_NUM_ (2UL*_FIXED_ADC_VREF_MV_)
+#define _GD_SPANEL_DEN_ _ADC_SERVICE_MAX_(_GD_SPANEL_ADC_BITS_)
+static constexpr uint32_t gd_spanel_q16 = fixed_q16(_GD_SPANEL_NUM_, _GD_SPANEL_DEN_);
+static_assert(fixed_q16_check(0, _GD_SPANEL_DEN_, _GD_SPANEL_NUM_, _GD_SPANEL_DEN_),
+              "gd_dev_spanel: fixed point scale off by more than one LSB");
+
+static uint8_t gd_spanel_adc;
 
 /******************************
  * 
@@ -21,6 +31,7 @@
  ******************************/
 void gd_dev_spanel_open(void){
     pinMode(_PIN_GD_SPANEL_, INPUT);
+    gd_spanel_adc = adc_service_add(_PIN_GD_SPANEL_, _GD_SPANEL_ADC_BITS_);
 }
 
 /******************************
@@ -32,14 +43,33 @@ void gd_dev_spanel_open(void){
  * 
  ******************************/
 int gd_dev_spanel_read(void){
-    float value = 555.0;
+    int value = 555;
     #ifndef SEN_STUB
 
     /* The solar panel has a maximum output voltage of 6V but the ATmega328P
     microcontroller only allows a maximum input voltage of 5V. To prevent a
     saturated signal reading, A physical voltage divider is implemented on the
     board. To account for this voltage divider, a scaling factor of 2 is used. */
-    value = 2.0 * (float)analogRead(_PIN_GD_SPANEL_) *(5000.0/1023);
+    value = fixed_mul_q16(adc_service_read(gd_spanel_adc), gd_spanel_q16);
     #endif
     return value;
 }
+
+/******************************
+ * 
+ * Name:        gd_dev_spanel_test
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Check solar panel voltage for POST
+ * 
+ ******************************/
+void gd_dev_spanel_test(void){
+    int spanel_val = gd_dev_spanel_read();
+    Serial.print(F("[P] spanel value: "));
+    Serial.print(spanel_val);
+    Serial.println(F(" mV"));
+
+    if(spanel_val < 100){
+        Serial.println(F("[P] \tERROR: spanel value out of range"));
+    }
+}
@@ -7,11 +7,15 @@
  ******************************/
 
 #include <Arduino.h>
+#include "../adc_service.h"
 
+// Oversampled to 12 bit
+#define _GD_SPANEL_ADC_BITS_ 2
 #define _PIN_GD_SPANEL_ A0
 
 #ifndef GD_DEV_SPANEL
 #define GD_DEV_SPANEL
 void gd_dev_spanel_open(void);
 int gd_dev_spanel_read(void);
+void gd_dev_spanel_test(void);
 #endif
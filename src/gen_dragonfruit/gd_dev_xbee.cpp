@@ -5,6 +5,24 @@
  * This module is a driver for the XBee module. It uses the XBee 
  * to construct and transmit sensor data in packets.
  *
+ * The radio is pin-sleep managed: it is woken before a frame goes
+ * out and put back to sleep once the TX status of every frame sent
+ * has come back. This needs the XBee configured as an end device
+ * with pin hibernate (ATSM1); a router ignores SLEEP_RQ.
+ *
+ * Data frames are tracked by frame ID. One frame is in flight at a
+ * time; it is resent with a growing backoff when its TX status
+ * reports a failure or does not come back. Writing never waits
+ * for the frame in flight: the next frame waits in a RAM slot
+ * and gd_dev_xbee_poll() sends it once the status is in.
+ *
+ * A frame that still isn't delivered is stored in the EEPROM
+ * queue, and so is every frame written while the queue is not
+ * empty or the RAM slot is taken, so stored frames go out before
+ * newer ones. The queue is drained one frame per TX status once
+ * a frame gets through again; while the link is down the oldest
+ * stored frame is retried every _GD_DEV_XBEE_PROBE_MS_.
+ *
  * Product page: http://www.digi.com/support/productdetail?pid=4549
  * Datasheet: http://www.digi.com/resources/documentation/digidocs/PDFs/90000976.pdf
  *
@@ -12,6 +30,162 @@
 
 #include "gd_dev_xbee.h"
 
+static XBee xbee = XBee();
+
+static uint8_t xbee_awake = 0;
+
+// Frame in flight. xbee_tx_len is 0 when there is none.
+static uint8_t xbee_tx_buf[_EEPROM_QUEUE_DATA_];
+static uint8_t xbee_tx_len = 0;
+static uint8_t xbee_tx_id = 0;          // Frame ID of the last send
+static uint8_t xbee_tx_tries = 0;
+static uint8_t xbee_tx_wait = 0;        // 1 waiting for the status, 0 for the retry
+static uint8_t xbee_tx_stored = 0;      // Frame is the head of the EEPROM queue
+static unsigned long xbee_tx_ms = 0;    // Time of the last send or failure
+
+// Next frame, sent once the one in flight is done. xbee_next_len
+// is 0 when there is none.
+static uint8_t xbee_next_buf[_EEPROM_QUEUE_DATA_];
+static uint8_t xbee_next_len = 0;
+
+static uint8_t xbee_link_down = 0;
+static unsigned long xbee_link_ms = 0;  // Time the link was marked down
+
+/******************************
+ * 
+ * Name:        gd_dev_xbee_sleep
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Put the XBee in pin sleep once everything
+ *              queued has been sent to it
+ * 
+ ******************************/
+static void gd_dev_xbee_sleep(void)
+{
+    xbee_serial.flush();
+    digitalWrite(_PIN_GD_XBEE_SLEEP_RQ_, HIGH);
+    xbee_awake = 0;
+}
+
+/******************************
+ * 
+ * Name:        gd_dev_xbee_wake
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Wake the XBee and idle until it reports that
+ *              it is awake on the On/SLEEP pin
+ * 
+ ******************************/
+static void gd_dev_xbee_wake(void)
+{
+    unsigned long start_ms = millis();
+
+    if(xbee_awake){
+        return;
+    }
+
+    digitalWrite(_PIN_GD_XBEE_SLEEP_RQ_, LOW);
+    while(digitalRead(_PIN_GD_XBEE_ON_) == LOW){
+        if(millis() - start_ms >= _GD_DEV_XBEE_WAKE_MS_){
+            Serial.println(F("XBee wake timeout"));
+            break;
+        }
+        sched_idle();
+    }
+    xbee_awake = 1;
+}
+
+/******************************
+ * 
+ * Name:        gd_dev_xbee_send
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: (Re)send the frame in flight with a new frame
+ *              ID
+ * 
+ ******************************/
+static void gd_dev_xbee_send(void)
+{
+    XBeeAddress64 addr64 = XBeeAddress64(0, 0);
+    ZBTxRequest zbtx = ZBTxRequest(addr64, xbee_tx_buf, xbee_tx_len);
+
+    // Frame ID 0 means no TX status
+    if(++xbee_tx_id == NO_RESPONSE_FRAME_ID){
+        xbee_tx_id++;
+    }
+    zbtx.setFrameId(xbee_tx_id);
+
+    gd_dev_xbee_wake();
+    xbee.send(zbtx);
+
+    xbee_tx_tries++;
+    xbee_tx_wait = 1;
+    xbee_tx_ms = millis();
+}
+
+/******************************
+ * 
+ * Name:        gd_dev_xbee_store
+ * Returns:     Nothing
+ * Parameter:   Payload, length
+ * Description: Append a payload to the EEPROM queue. A full
+ *              queue overwrites its oldest payload, and if that
+ *              is the frame in flight, the copy in xbee_tx_buf
+ *              is the only one left: it is no longer popped
+ *              when delivered, and is stored again as the
+ *              newest payload if it is not.
+ * 
+ ******************************/
+static void gd_dev_xbee_store(const uint8_t *data, uint8_t data_len)
+{
+    if(xbee_tx_len && xbee_tx_stored &&
+       eeprom_queue_count() == _EEPROM_QUEUE_SLOTS_){
+        xbee_tx_stored = 0;
+    }
+    eeprom_queue_push(data, data_len);
+}
+
+/******************************
+ * 
+ * Name:        gd_dev_xbee_tx_done
+ * Returns:     Nothing
+ * Parameter:   1 if the frame in flight was delivered
+ * Description: Release the frame, schedule a retry, or store
+ *              the frame once it is out of retries
+ * 
+ ******************************/
+static void gd_dev_xbee_tx_done(uint8_t delivered)
+{
+    if(delivered){
+        if(xbee_tx_stored){
+            eeprom_queue_pop();
+        }
+        xbee_tx_len = 0;
+        xbee_link_down = 0;
+        return;
+    }
+
+    xbee_tx_wait = 0;
+    xbee_tx_ms = millis();
+    if(xbee_tx_tries < _GD_DEV_XBEE_TRIES_){
+        return;
+    }
+
+    Serial.println(F("XBee frame not delivered, stored"));
+    if(!xbee_tx_stored){
+        gd_dev_xbee_store(xbee_tx_buf, xbee_tx_len);
+    }
+
+    // The waiting frame is newer, it goes in after
+    if(xbee_next_len){
+        gd_dev_xbee_store(xbee_next_buf, xbee_next_len);
+        xbee_next_len = 0;
+    }
+    xbee_tx_len = 0;
+    xbee_link_down = 1;
+    xbee_link_ms = millis();
+}
+
 /******************************
  * 
  * Name:        gd_dev_xbee_open
@@ -22,72 +196,187 @@
  ******************************/
 void gd_dev_xbee_open(void)
 {
-    soft_serial.begin(9600);
-    xbee.begin(soft_serial);
+    xbee_serial.begin(_GD_DEV_XBEE_BAUD_, _PIN_GD_XBEE_RX_, _PIN_GD_XBEE_TX_);
+    xbee.begin(xbee_serial);
+    xbee_rx_open();
+    eeprom_queue_open();
     // Enable voltage regulator pin to power the Xbee 
     digitalWrite(3, HIGH);
 
     // Configure pin connected to DTR on XBee
-    // Since in router mode we don't care what the output is
-    // so we can drive this signal LOW by default
-    pinMode(A1, OUTPUT);
-    digitalWrite(A1, LOW);
+    // Driving it HIGH puts the XBee in pin sleep until
+    // the first frame is sent
+    pinMode(_PIN_GD_XBEE_SLEEP_RQ_, OUTPUT);
+    gd_dev_xbee_sleep();
 
     // Configure pin connected to RSSI on XBee
     // Since RSSI pin is set to output on XBee, set the RSSI pin to
     // input on MCU
-    pinMode(A2, INPUT);
+    pinMode(_PIN_GD_XBEE_RSSI_, INPUT);
 
     // Configure pin connected to XBee sleep pin on XBee
     // Since the XBee sleep pin is set to output on XBee, set 
     // the pin to input on MCU
-    pinMode(A3, INPUT);
+    pinMode(_PIN_GD_XBEE_ON_, INPUT);
 }
 
 /******************************
  * 
- * Name:        gd_dev_xbee_avail
- * Returns:     The number of bytes available to read 
- * Parameter:   Nothing
- * Description: Number of characters available for reading from the serial port 
+ * Name:        gd_dev_xbee_write
+ * Returns:     Nothing
+ * Parameter:   Payload, length
+ * Description: Transmit a payload with delivery tracking.
+ *              Never waits: while a frame is in flight the
+ *              payload is queued in the RAM slot, or in the
+ *              EEPROM queue if that is taken, stored frames are
+ *              waiting or the link is down.
  * 
  ******************************/
-int gd_dev_xbee_avail(void)
+void gd_dev_xbee_write(uint8_t *data, int data_len)
 {
-    return Serial.available();
+    if(data_len > _EEPROM_QUEUE_DATA_){
+        data_len = _EEPROM_QUEUE_DATA_;
+    }
+
+    // Stored frames go out first
+    if(xbee_next_len || xbee_link_down || eeprom_queue_count()){
+        gd_dev_xbee_store(data, data_len);
+        return;
+    }
+    if(xbee_tx_len){
+        memcpy(xbee_next_buf, data, data_len);
+        xbee_next_len = data_len;
+        return;
+    }
+
+    memcpy(xbee_tx_buf, data, data_len);
+    xbee_tx_len = data_len;
+    xbee_tx_tries = 0;
+    xbee_tx_stored = 0;
+    gd_dev_xbee_send();
 }
 
 /******************************
  * 
- * Name:        gd_dev_xbee_read
- * Returns:     The first byte of incoming serial data available
- *              (or -1 if no data is available)
- * Parameter:   Nothing
- * Description: Readings incoming serial data
+ * Name:        gd_dev_xbee_write_once
+ * Returns:     Nothing
+ * Parameter:   Payload, length
+ * Description: Transmit a payload without a TX status, for
+ *              heartbeats that are not worth storing. Dropped
+ *              while the link is down.
  * 
  ******************************/
-int gd_dev_xbee_read(void)
+void gd_dev_xbee_write_once(uint8_t *data, int data_len)
 {
-    return Serial.read();
+    XBeeAddress64 addr64 = XBeeAddress64(0, 0);
+    ZBTxRequest zbtx = ZBTxRequest(addr64, data, data_len);
+
+    if(xbee_link_down){
+        return;
+    }
+
+    zbtx.setFrameId(NO_RESPONSE_FRAME_ID);
+    gd_dev_xbee_wake();
+    xbee.send(zbtx);
 }
 
 /******************************
  * 
- * Name:        gd_dev_xbee_write
+ * Name:        gd_dev_xbee_poll
  * Returns:     Nothing
  * Parameter:   Nothing
- * Description: Transmit packet through XBee
+ * Description: Dispatch the frames received from the XBee by
+ *              API ID, run the retries and the EEPROM queue
+ *              drain, and put the radio back to sleep once no
+ *              frame is in flight
  * 
  ******************************/
-void gd_dev_xbee_write(uint8_t *data, int data_len)
+void gd_dev_xbee_poll(void)
 {
-    // Specify the address of the remote XBee
-    XBeeAddress64 addr64 = XBeeAddress64(0, 0);
+    struct xbee_rx_frame* f;
 
-    // Create a TX request
-    ZBTxRequest zbtx = ZBTxRequest(addr64, data, data_len);
+    while((f = xbee_rx_peek()) != NULL){
+        switch(f->data[_XBEE_RX_API_ID_]){
+            case ZB_TX_STATUS_RESPONSE:
+                // Late status of an earlier try is ignored
+                if(xbee_tx_len && xbee_tx_wait &&
+                   f->data[_XBEE_RX_TX_FRAME_ID_] == xbee_tx_id){
+                    gd_dev_xbee_tx_done(f->data[_XBEE_RX_TX_DELIVERY_] == 0);
+                }
+                break;
+            case MODEM_STATUS_RESPONSE:
+                Serial.print(F("XBee modem status: "));
+                Serial.println(f->data[_XBEE_RX_MODEM_STATUS_], HEX);
+                break;
+            case ZB_RX_RESPONSE:
+                if(time_sync_rx(&f->data[_XBEE_RX_ZB_DATA_],
+                                f->len - _XBEE_RX_ZB_DATA_, f->ms)){
+                    break;
+                }
+                console_rx(&f->data[_XBEE_RX_ZB_DATA_], f->len - _XBEE_RX_ZB_DATA_);
+                break;
+        }
+        xbee_rx_pop();
+    }
 
-    // Send request
-    xbee.send(zbtx);
+    if(xbee_rx_dropped()){
+        Serial.println(F("XBee RX frame dropped"));
+    }
+
+    if(xbee_tx_len){
+        if(xbee_tx_wait){
+            if(millis() - xbee_tx_ms >= _GD_DEV_XBEE_STATUS_MS_){
+                Serial.println(F("XBee TX status timeout"));
+                gd_dev_xbee_tx_done(0);
+            }
+        }
+        else if(millis() - xbee_tx_ms >= (_GD_DEV_XBEE_RETRY_MS_ << (xbee_tx_tries - 1))){
+            gd_dev_xbee_send();
+        }
+    }
+
+    // The frame waiting in RAM is older than anything stored
+    if(xbee_tx_len == 0 && xbee_next_len){
+        memcpy(xbee_tx_buf, xbee_next_buf, xbee_next_len);
+        xbee_tx_len = xbee_next_len;
+        xbee_next_len = 0;
+        xbee_tx_tries = 0;
+        xbee_tx_stored = 0;
+        gd_dev_xbee_send();
+    }
+
+    // Drain the EEPROM queue, or probe the link with the oldest
+    // stored frame while it is down
+    if(xbee_tx_len == 0 && eeprom_queue_count() &&
+       (!xbee_link_down || millis() - xbee_link_ms >= _GD_DEV_XBEE_PROBE_MS_)){
+        xbee_tx_len = eeprom_queue_peek(xbee_tx_buf, sizeof(xbee_tx_buf));
+        xbee_tx_tries = 0;
+        xbee_tx_stored = 1;
+        xbee_link_ms = millis();
+        if(xbee_tx_len){
+            gd_dev_xbee_send();
+        }
+        else{
+            eeprom_queue_pop();
+        }
+    }
+
+    if(xbee_awake && xbee_tx_len == 0){
+        gd_dev_xbee_sleep();
+    }
+}
+
+/******************************
+ * 
+ * Name:        gd_dev_xbee_awake
+ * Returns:     1 while the XBee is awake
+ * Parameter:   Nothing
+ * Description: Used to keep the MCU out of power-down while
+ *              waiting for a TX status
+ * 
+ ******************************/
+uint8_t gd_dev_xbee_awake(void)
+{
+    return xbee_awake;
 }
 
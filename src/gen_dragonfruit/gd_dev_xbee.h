@@ -8,20 +8,39 @@
 
 #include <Arduino.h>
 #include <XBee.h>
-#include <SoftwareSerial.h>
+#include "../soft_uart.h"
+#include "../xbee_rx.h"
+#include "../time_sync.h"
+#include "../console.h"
+#include "../eeprom_queue.h"
+#include "../sched.h"
 
-#define _GD_DEV_XBEE_BUFSIZE_ 150
+#define _PIN_GD_XBEE_RX_ 2
+#define _PIN_GD_XBEE_TX_ 8
+#define _PIN_GD_XBEE_SLEEP_RQ_ A1   // XBee DTR/SLEEP_RQ, HIGH to sleep
+#define _PIN_GD_XBEE_RSSI_ A2
+#define _PIN_GD_XBEE_ON_ A3         // XBee On/SLEEP, HIGH when awake
+
+// Longest wait for On/SLEEP after a wake request, and for the
+// TX status of a frame before the radio is put back to sleep
+#define _GD_DEV_XBEE_WAKE_MS_ 100
+#define _GD_DEV_XBEE_STATUS_MS_ 3000
+
+// Sends of a data frame before it is stored in EEPROM, the
+// backoff before the first retry (doubled for each retry) and
+// how often the link is probed while it is down
+#define _GD_DEV_XBEE_TRIES_ 4
+#define _GD_DEV_XBEE_RETRY_MS_ 250UL
+#define _GD_DEV_XBEE_PROBE_MS_ (1000UL*60)
+
+// Must match the XBee ATBD setting
+#define _GD_DEV_XBEE_BAUD_ 9600
 
 #ifndef GD_DEV_XBEE
 #define GD_DEV_XBEE
 void gd_dev_xbee_open(void);
-int gd_dev_xbee_avail(void);
-int gd_dev_xbee_read(void);
 void gd_dev_xbee_write(uint8_t* data, int data_len);
-
-static XBee xbee = XBee();
-
-const byte rx_pin = 2;
-const byte tx_pin = 8;
-static SoftwareSerial soft_serial(rx_pin, tx_pin);
+void gd_dev_xbee_write_once(uint8_t* data, int data_len);
+void gd_dev_xbee_poll(void);
+uint8_t gd_dev_xbee_awake(void);
 #endif
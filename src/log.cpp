@@ -1,10 +1,109 @@
+/*******************************
+ *
+ * File: log.cpp
+ *
+ * Deferred binary event log. See log.h.
+ *
+ ******************************/
+
 #include "log.h"
-void print_log(const char str[]){
-#ifdef DEBUG
-    Serial.print("[");
-    Serial.print(millis());
-    Serial.print("]");
-    Serial.print("   ");
-    Serial.println(str);
-#endif
+
+struct log_record{
+    uint8_t event;
+    unsigned long ms;
+    uint16_t arg;
+};
+
+static struct log_record ring[_LOG_RING_LEN_];
+static uint8_t head = 0;
+static uint8_t count = 0;
+static uint16_t dropped = 0;
+
+/******************************
+ *
+ * Name:        log_push
+ * Returns:     Nothing
+ * Parameter:   Event, argument
+ * Description: Queue a record. Use print_log(), which drops
+ *              the call when the level is compiled out. When the
+ *              ring is full the record is counted as dropped and
+ *              a LOG_DROPPED record goes out once there is room.
+ *
+ ******************************/
+void log_push(uint8_t event, uint16_t arg){
+    struct log_record* r;
+
+    if(count >= _LOG_RING_LEN_){
+        if(dropped < 0xFFFF){
+            dropped++;
+        }
+        return;
+    }
+
+    r = &ring[(head + count) % _LOG_RING_LEN_];
+    r->event = event;
+    r->ms = millis();
+    r->arg = arg;
+    count++;
+}
+
+static void log_write(const struct log_record* r){
+    uint8_t rec[_LOG_RECORD_LEN_];
+    uint8_t sum = 0;
+    uint8_t i;
+
+    rec[0] = _LOG_SYNC_;
+    rec[1] = r->event;
+    for(i = 0; i < 4; i++){
+        rec[2 + i] = r->ms >> (8 * i);
+    }
+    rec[6] = r->arg;
+    rec[7] = r->arg >> 8;
+    for(i = 1; i < _LOG_RECORD_LEN_ - 1; i++){
+        sum ^= rec[i];
+    }
+    rec[8] = sum;
+    Serial.write(rec, sizeof(rec));
+}
+
+/******************************
+ *
+ * Name:        log_flush
+ * Returns:     Nothing
+ * Parameter:   1 to write every record, 0 to stop once the
+ *              serial buffer is full
+ * Description: Called from the main loop without waiting, and
+ *              with waiting before the console prints, so
+ *              its output isn't mixed with stale records
+ *
+ ******************************/
+void log_flush(uint8_t wait){
+    while(count > 0){
+        if(!wait && Serial.availableForWrite() < _LOG_RECORD_LEN_){
+            return;
+        }
+        log_write(&ring[head]);
+        head = (head + 1) % _LOG_RING_LEN_;
+        count--;
+
+        if(dropped && count < _LOG_RING_LEN_){
+            uint16_t n = dropped;
+
+            dropped = 0;
+            log_push(LOG_DROPPED, n);
+        }
+    }
+}
+
+/******************************
+ *
+ * Name:        log_pending
+ * Returns:     1 while records are waiting for the port
+ * Parameter:   Nothing
+ * Description: The scheduler idles instead of powering down, so
+ *              the serial interrupt keeps draining the port
+ *
+ ******************************/
+uint8_t log_pending(void){
+    return count > 0;
 }
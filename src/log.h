@@ -1,4 +1,73 @@
+/*******************************
+ *
+ * File: log.h
+ *
+ * Deferred binary event log. print_log() stores a 7 byte record
+ * (event, millis(), argument) in a RAM ring instead of printing
+ * text, and log_flush() writes the records to the serial port
+ * only as fast as the hardware serial buffer takes them, so a
+ * task never blocks on a 9600 baud port.
+ *
+ * Each record goes out as 9 bytes: _LOG_SYNC_, event, ms (u32 LE),
+ * arg (u16 LE), then the XOR of the 7 bytes in between. The sync
+ * byte never shows up in the text printed on the same port, so
+ * utils/log_decode/log_decode.py can pick the records out of the
+ * stream and print them using the text of LOG_EVENTS below.
+ *
+ * The level is chosen at compile time with -DLOG_LEVEL=N (0 off,
+ * 1 error, 2 warn, 3 info, 4 debug). The default is info, debug
+ * with -DDEBUG. Events above it compile to nothing.
+ *
+ ******************************/
+
 #include <Arduino.h>
 
-void print_log(const char str[]);
+#define _LOG_ERROR_ 1
+#define _LOG_WARN_ 2
+#define _LOG_INFO_ 3
+#define _LOG_DEBUG_ 4
+
+#ifdef LOG_LEVEL
+#define _LOG_LEVEL_ LOG_LEVEL
+#elif defined(DEBUG)
+#define _LOG_LEVEL_ _LOG_DEBUG_
+#else
+#define _LOG_LEVEL_ _LOG_INFO_
+#endif
+
+// Records held until the port takes them
+#define _LOG_RING_LEN_ 12
+#define _LOG_SYNC_ 0x1E
+#define _LOG_RECORD_LEN_ 9
+
+// Every event: name, how the host decoder reads the arg (u16 or
+// s16) and the text it prints. Only append, the decoder numbers
+// them in this order.
+#define LOG_EVENTS(X) \
+    X(LOG_DROPPED,          u16, "Log records dropped") \
+    X(LOG_SAMPLE_START,     u16, "Sample Start") \
+    X(LOG_SAMPLE_END,       u16, "Sample End, queued") \
+    X(LOG_SAMPLE_UNCHANGED, u16, "Sample unchanged, not sent") \
+    X(LOG_TX_START,         u16, "Sample TX Start, queued") \
+    X(LOG_TX_END,           u16, "Sample TX End") \
+    X(LOG_HEARTBEAT_START,  u16, "TX Heartbeat Start") \
+    X(LOG_HEARTBEAT_END,    u16, "TX Heartbeat End") \
+    X(LOG_TIME_SYNC,        s16, "Time sync, drift ppm")
+
+#ifndef LOG_H
+#define LOG_H
+
+#define LOG_EVENT_ID(name, type, text) name,
+enum log_event{
+    LOG_EVENTS(LOG_EVENT_ID)
+    LOG_EVENT_COUNT
+};
+#undef LOG_EVENT_ID
+
+void log_push(uint8_t event, uint16_t arg);
+void log_flush(uint8_t wait);
+uint8_t log_pending(void);
 
+#define print_log(level, event, arg) \
+    do{ if((level) <= _LOG_LEVEL_) log_push((event), (arg)); }while(0)
+#endif
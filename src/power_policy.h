@@ -0,0 +1,189 @@
+/*******************************
+ *
+ * File: power_policy.h
+ *
+ * Energy aware sample and uplink intervals. After every sample
+ * the battery and panel voltages move the board between power
+ * levels; each level has its own sample period and number of
+ * samples per uplink. Level 0 (full battery, panel charging)
+ * samples fastest, level 1 is the normal 30 s period and the last
+ * level keeps the box alive through long low light periods.
+ *
+ * The battery voltage is smoothed and compared against the
+ * level thresholds with hysteresis, so a reading that hovers
+ * around a threshold does not flip the level each sample. A
+ * battery that keeps falling with no charge from the panel
+ * drops one level early.
+ *
+ ******************************/
+
+#include <Arduino.h>
+#include "clock.h"
+
+// Floor and ceiling of the sample period. Override with
+// -DSAMPLE_MIN_S=N / -DSAMPLE_MAX_S=N in platformio.ini.
+#ifdef SAMPLE_MIN_S
+#define _POWER_POLICY_MIN_MS_ (1000UL*SAMPLE_MIN_S)
+#else
+#define _POWER_POLICY_MIN_MS_ (1000UL*15)
+#endif
+#ifdef SAMPLE_MAX_S
+#define _POWER_POLICY_MAX_MS_ (1000UL*SAMPLE_MAX_S)
+#else
+#define _POWER_POLICY_MAX_MS_ (1000UL*60*10)
+#endif
+
+// Sample period of level 0, doubled for each level after it
+#define _POWER_POLICY_BASE_MS_ (1000UL*15)
+
+// Battery voltages (mV) below which the board drops from level
+// 0, 1 and 2 to the next level. The battery must rise
+// _POWER_POLICY_HYST_MV_ above a threshold to move back up.
+#define _POWER_POLICY_LEVELS_ 4
+#define _POWER_POLICY_FULL_MV_ 4050
+#define _POWER_POLICY_NORMAL_MV_ 3750
+#define _POWER_POLICY_LOW_MV_ 3550
+#define _POWER_POLICY_HYST_MV_ 50
+
+// The panel charges the battery when it is this much above it
+#define _POWER_POLICY_CHARGE_MV_ 300
+
+// The trend is the change of the smoothed battery voltage over
+// each _POWER_POLICY_TREND_MS_
+#define _POWER_POLICY_TREND_MS_ (1000UL*60*10)
+#define _POWER_POLICY_FALL_MV_ 20
+
+#ifndef POWER_POLICY_H
+#define POWER_POLICY_H
+
+static_assert(_POWER_POLICY_MIN_MS_ <= _POWER_POLICY_MAX_MS_,
+              "sample period floor is above the ceiling");
+
+struct power_policy{
+    uint8_t level;
+    uint16_t batt_avg_mv;       // Smoothed battery voltage
+    uint16_t trend_ref_mv;      // batt_avg_mv at the start of the trend window
+    int16_t trend_mv;           // Change over the last trend window
+    uint64_t trend_ms;          // Start of the trend window
+    unsigned long sample_ms;    // Current sample period
+    uint8_t tx_samples;         // Samples per uplink
+
+    /******************************
+     *
+     * Name:        power_policy::level_sample_ms
+     * Returns:     Sample period of a level, between the floor
+     *              and the ceiling
+     * Parameter:   Level
+     * Description: Doubles for each level, except the last one
+     *              which goes straight to the ceiling
+     *
+     ******************************/
+    static unsigned long level_sample_ms(uint8_t lvl){
+        unsigned long ms = _POWER_POLICY_BASE_MS_ << lvl;
+
+        if(lvl == _POWER_POLICY_LEVELS_ - 1 || ms > _POWER_POLICY_MAX_MS_){
+            ms = _POWER_POLICY_MAX_MS_;
+        }
+        if(ms < _POWER_POLICY_MIN_MS_){
+            ms = _POWER_POLICY_MIN_MS_;
+        }
+        return ms;
+    }
+
+    /******************************
+     *
+     * Name:        power_policy::threshold_mv
+     * Returns:     Battery voltage below which the board drops
+     *              from a level to the next one
+     * Parameter:   Level (0 to _POWER_POLICY_LEVELS_ - 2)
+     * Description: Nothing
+     *
+     ******************************/
+    static uint16_t threshold_mv(uint8_t lvl){
+        switch(lvl){
+            case 0: return _POWER_POLICY_FULL_MV_;
+            case 1: return _POWER_POLICY_NORMAL_MV_;
+            default: return _POWER_POLICY_LOW_MV_;
+        }
+    }
+
+    /******************************
+     *
+     * Name:        power_policy::init
+     * Returns:     Nothing
+     * Parameter:   Largest number of samples per uplink
+     * Description: Start at level 1 until the first sample
+     *
+     ******************************/
+    void init(uint8_t max_tx_samples){
+        level = 1;
+        batt_avg_mv = 0;
+        trend_ref_mv = 0;
+        trend_mv = 0;
+        trend_ms = 0;
+        sample_ms = level_sample_ms(level);
+        tx_samples = max_tx_samples;
+    }
+
+    /******************************
+     *
+     * Name:        power_policy::update
+     * Returns:     Nothing
+     * Parameter:   Battery voltage (mV), panel voltage (mV),
+     *              largest number of samples per uplink
+     * Description: Pick the power level for the next sample
+     *
+     ******************************/
+    void update(uint16_t batt_mv, uint16_t panel_mv, uint8_t max_tx_samples){
+        uint8_t charging = panel_mv > batt_mv + _POWER_POLICY_CHARGE_MV_;
+        uint8_t target = 0;
+
+        // Exponential average, 1/4 of each new reading
+        if(batt_avg_mv == 0){
+            batt_avg_mv = batt_mv;
+            trend_ref_mv = batt_mv;
+            trend_ms = clock_ms();
+        }
+        else{
+            batt_avg_mv += ((int16_t)(batt_mv - batt_avg_mv)) / 4;
+        }
+
+        if(clock_ms() - trend_ms >= _POWER_POLICY_TREND_MS_){
+            trend_mv = batt_avg_mv - trend_ref_mv;
+            trend_ref_mv = batt_avg_mv;
+            trend_ms = clock_ms();
+        }
+
+        // Level the battery voltage alone asks for, staying at
+        // the current level inside the hysteresis band
+        while(target < _POWER_POLICY_LEVELS_ - 1){
+            uint16_t mv = threshold_mv(target);
+
+            if(target < level){
+                mv += _POWER_POLICY_HYST_MV_;
+            }
+            if(batt_avg_mv >= mv){
+                break;
+            }
+            target++;
+        }
+
+        // Full speed only while the panel keeps the battery up
+        if(target == 0 && !charging){
+            target = 1;
+        }
+        if(!charging && trend_mv <= -_POWER_POLICY_FALL_MV_ &&
+           target < _POWER_POLICY_LEVELS_ - 1){
+            target++;
+        }
+
+        // The sample ring bounds the batch, so the uplink interval
+        // stretches with the sample period. Level 0 sends every
+        // sample while there is energy to spare.
+        level = target;
+        sample_ms = level_sample_ms(level);
+        tx_samples = level == 0 ? 1 : max_tx_samples;
+    }
+};
+
+#endif
@@ -0,0 +1,156 @@
+/*******************************
+ *
+ * File: prof.cpp
+ *
+ * Profiling stats. See prof.h.
+ *
+ ******************************/
+
+#include "prof.h"
+
+#ifdef PROFILE
+
+#include <avr/pgmspace.h>
+
+struct prof_stat{
+    uint16_t count;
+    unsigned long min_us;
+    unsigned long max_us;
+    unsigned long sum_us;
+};
+
+static struct prof_stat stats[PROF_COUNT];
+
+static const char prof_name_sample[] PROGMEM = "sample";
+static const char prof_name_tx[] PROGMEM = "tx";
+static const char prof_name_heartbeat[] PROGMEM = "heartbeat";
+static const char prof_name_irr_sample[] PROGMEM = "irr_sample";
+static const char prof_name_xbee_poll[] PROGMEM = "xbee_poll";
+static const char prof_name_cmd[] PROGMEM = "cmd";
+static const char prof_name_batt[] PROGMEM = "read batt";
+static const char prof_name_spanel[] PROGMEM = "read spanel";
+static const char prof_name_irr[] PROGMEM = "read irr";
+static const char prof_name_press[] PROGMEM = "read press";
+static const char prof_name_temp[] PROGMEM = "read temp";
+static const char prof_name_humidity[] PROGMEM = "read humidity";
+
+static const char* const prof_names[PROF_COUNT] PROGMEM = {
+    prof_name_sample,
+    prof_name_tx,
+    prof_name_heartbeat,
+    prof_name_irr_sample,
+    prof_name_xbee_poll,
+    prof_name_cmd,
+    prof_name_batt,
+    prof_name_spanel,
+    prof_name_irr,
+    prof_name_press,
+    prof_name_temp,
+    prof_name_humidity,
+};
+
+/******************************
+ *
+ * Name:        prof_record
+ * Returns:     Nothing
+ * Parameter:   Profile id, duration in us
+ * Description: Add a duration to the stats of an id. The sum
+ *              and count are halved before the sum overflows,
+ *              which keeps the mean.
+ *
+ ******************************/
+void prof_record(uint8_t id, unsigned long us){
+    struct prof_stat* s = &stats[id];
+
+    if(s->count == 0xFFFF || s->sum_us + us < s->sum_us){
+        s->count /= 2;
+        s->sum_us /= 2;
+    }
+    if(s->count == 0 || us < s->min_us){
+        s->min_us = us;
+    }
+    if(us > s->max_us){
+        s->max_us = us;
+    }
+    s->sum_us += us;
+    s->count++;
+}
+
+static unsigned long prof_mean_us(const struct prof_stat* s){
+    return s->count ? s->sum_us / s->count : 0;
+}
+
+/******************************
+ *
+ * Name:        prof_dump
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Print count, min, max and mean of every id
+ *
+ ******************************/
+void prof_dump(void){
+    uint8_t i;
+
+    Serial.println(F("name count min_us max_us mean_us"));
+    for(i = 0; i < PROF_COUNT; i++){
+        const struct prof_stat* s = &stats[i];
+
+        Serial.print((const __FlashStringHelper*)pgm_read_ptr(&prof_names[i]));
+        Serial.print(' ');
+        Serial.print(s->count);
+        Serial.print(' ');
+        Serial.print(s->min_us);
+        Serial.print(' ');
+        Serial.print(s->max_us);
+        Serial.print(' ');
+        Serial.println(prof_mean_us(s));
+    }
+}
+
+/******************************
+ *
+ * Name:        prof_clear
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Reset every stat
+ *
+ ******************************/
+void prof_clear(void){
+    memset(stats, 0, sizeof(stats));
+}
+
+static uint16_t prof_diag_units(unsigned long us){
+    us /= _PROF_DIAG_UNIT_US_;
+    return us > 0xFFFF ? 0xFFFF : us;
+}
+
+/******************************
+ *
+ * Name:        prof_write
+ * Returns:     Nothing
+ * Parameter:   Frame writer, node address
+ * Description: Serialize the diagnostics frame
+ *
+ ******************************/
+void prof_write(struct frame_writer* w, uint16_t node_addr){
+    uint8_t i;
+
+    // Written field by field rather than through a struct, which
+    // would need _PROF_DIAG_LEN_ bytes of stack
+    static_assert(_PROF_DIAG_LEN_ == 4 + 6 * PROF_COUNT,
+                  "SCHEMA_PROF_DIAG_FIELDS does not match prof_id");
+
+    w->u16(_SCHEMA_PROF_DIAG_);
+    w->u16(node_addr);
+    for(i = 0; i < PROF_COUNT; i++){
+        w->u16(prof_diag_units(stats[i].min_us));
+    }
+    for(i = 0; i < PROF_COUNT; i++){
+        w->u16(prof_diag_units(stats[i].max_us));
+    }
+    for(i = 0; i < PROF_COUNT; i++){
+        w->u16(prof_diag_units(prof_mean_us(&stats[i])));
+    }
+}
+
+#endif
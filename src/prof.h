@@ -0,0 +1,79 @@
+/*******************************
+ *
+ * File: prof.h
+ *
+ * Task and device read profiling. Build with -DPROFILE to
+ * record the min, max and mean duration of each task and of
+ * each device read, measured with micros() (4 us resolution at
+ * 16 MHz, 8 us at 8 MHz). Without it the macros compile to
+ * nothing.
+ *
+ *   PROF_SCOPE(id)             Time the rest of the block
+ *   PROF_CALL(id, expr)        Time an expression, keeps its value
+ *
+ * The stats are printed by the D console command. With
+ * -DPROFILE_DIAG they are also sent in a diagnostics frame
+ * after every heartbeat, see prof_write().
+ *
+ ******************************/
+
+#include <Arduino.h>
+#include "frame_writer.h"
+#include "schema.h"
+
+// Diagnostics frame, see SCHEMA_PROF_DIAG_FIELDS in schema.h.
+// Durations are u16 in _PROF_DIAG_UNIT_US_ (saturating).
+#define _PROF_DIAG_UNIT_US_ 16
+
+#ifndef PROF_H
+#define PROF_H
+
+enum prof_id{
+    // Board tasks
+    PROF_SAMPLE,
+    PROF_TX,
+    PROF_HEARTBEAT,
+    PROF_IRR_SAMPLE,
+    PROF_XBEE_POLL,
+    PROF_CMD,
+
+    // Device reads, by quantity so every generation shares them
+    PROF_READ_BATT,
+    PROF_READ_SPANEL,
+    PROF_READ_IRR,
+    PROF_READ_PRESS,
+    PROF_READ_TEMP,
+    PROF_READ_HUMIDITY,
+
+    PROF_COUNT
+};
+
+#define _PROF_DIAG_LEN_ SCHEMA_LEN(SCHEMA_PROF_DIAG_FIELDS)
+
+#ifdef PROFILE
+
+void prof_record(uint8_t id, unsigned long us);
+void prof_dump(void);
+void prof_clear(void);
+void prof_write(struct frame_writer* w, uint16_t node_addr);
+
+struct prof_scope{
+    uint8_t id;
+    unsigned long start_us;
+
+    prof_scope(uint8_t scope_id) : id(scope_id), start_us(micros()){}
+    ~prof_scope(){
+        prof_record(id, micros() - start_us);
+    }
+};
+
+#define PROF_SCOPE(id) struct prof_scope prof_scope_(id)
+#define PROF_CALL(id, expr) ([&]{ struct prof_scope prof_scope_(id); return (expr); }())
+
+#else
+
+#define PROF_SCOPE(id)
+#define PROF_CALL(id, expr) (expr)
+
+#endif
+#endif
@@ -0,0 +1,71 @@
+/*******************************
+ *
+ * File: ram_watch.cpp
+ *
+ * SRAM canary painting and scanning. See ram_watch.h.
+ *
+ ******************************/
+
+#include "ram_watch.h"
+
+// Provided by the linker script and by malloc()
+extern uint8_t _end;
+extern uint8_t __heap_start;
+extern char* __brkval;
+
+void ram_watch_paint(void) __attribute__((naked, used, section(".init3")));
+
+/******************************
+ *
+ * Name:        ram_watch_paint
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Paint the free SRAM with the canary. Placed in
+ *              .init3, after the stack pointer is set and r1 is
+ *              cleared but before .data and .bss are set up, so
+ *              nothing lives above _end yet. Naked, the init
+ *              sections fall through to each other.
+ *
+ ******************************/
+void ram_watch_paint(void){
+    uint8_t* p = &_end;
+
+    while(p <= (uint8_t*)RAMEND){
+        *p++ = _RAM_WATCH_CANARY_;
+    }
+}
+
+static uint8_t* ram_watch_heap_top(void){
+    return __brkval ? (uint8_t*)__brkval : &__heap_start;
+}
+
+/******************************
+ *
+ * Name:        ram_watch_free_min
+ * Returns:     Smallest gap between heap and stack since boot,
+ *              in bytes
+ * Parameter:   Nothing
+ * Description: Count the canary bytes left above the heap
+ *
+ ******************************/
+uint16_t ram_watch_free_min(void){
+    uint8_t* p = ram_watch_heap_top();
+
+    while(p <= (uint8_t*)RAMEND && *p == _RAM_WATCH_CANARY_){
+        p++;
+    }
+    return p - ram_watch_heap_top();
+}
+
+/******************************
+ *
+ * Name:        ram_watch_stack_max
+ * Returns:     Deepest stack use since boot, in bytes
+ * Parameter:   Nothing
+ * Description: Everything from the first byte above the free gap
+ *              to RAMEND has been written by the stack
+ *
+ ******************************/
+uint16_t ram_watch_stack_max(void){
+    return (uint8_t*)RAMEND + 1 - (ram_watch_heap_top() + ram_watch_free_min());
+}
@@ -0,0 +1,27 @@
+/*******************************
+ *
+ * File: ram_watch.h
+ *
+ * SRAM usage tracking. At boot, before the C runtime runs, every
+ * byte from the end of .bss to RAMEND is painted with a canary
+ * value. The heap grows up into it and the stack down into it,
+ * and the bytes still holding the canary show how close the two
+ * have come since boot.
+ *
+ * A stack byte that happens to hold the canary value makes the
+ * result a byte or two optimistic, good enough to spot the trend
+ * across a fleet. Both marks go out in every heartbeat, which
+ * keeps coming every few hours after the boot burst.
+ *
+ ******************************/
+
+#include <Arduino.h>
+
+#define _RAM_WATCH_CANARY_ 0xC5
+
+#ifndef RAM_WATCH_H
+#define RAM_WATCH_H
+
+uint16_t ram_watch_free_min(void);
+uint16_t ram_watch_stack_max(void);
+#endif
@@ -0,0 +1,97 @@
+/*******************************
+ *
+ * File: sample_ring.h
+ *
+ * Fixed size ring buffer used to hold samples in RAM until
+ * they are transmitted. When the ring is full the oldest
+ * sample is overwritten.
+ *
+ ******************************/
+
+#include <Arduino.h>
+
+#ifndef SAMPLE_RING_H
+#define SAMPLE_RING_H
+
+template <class T, uint8_t N>
+struct sample_ring{
+    T buf[N];
+    uint8_t head;       // Index of the oldest sample
+    uint8_t count;      // Number of samples in the ring
+
+    /******************************
+     *
+     * Name:        sample_ring::clear
+     * Returns:     Nothing
+     * Parameter:   Nothing
+     * Description: Drop every sample in the ring
+     *
+     ******************************/
+    void clear(void){
+        head = 0;
+        count = 0;
+    }
+
+    /******************************
+     *
+     * Name:        sample_ring::push
+     * Returns:     Nothing
+     * Parameter:   Sample to store
+     * Description: Append a sample, overwriting the oldest
+     *              one if the ring is full
+     *
+     ******************************/
+    void push(const T& sample){
+        uint8_t tail = head + count;
+
+        if(tail >= N){
+            tail -= N;
+        }
+        buf[tail] = sample;
+
+        if(count < N){
+            count++;
+        }
+        else if(++head >= N){
+            head = 0;
+        }
+    }
+
+    /******************************
+     *
+     * Name:        sample_ring::peek
+     * Returns:     Sample at the given position
+     * Parameter:   Position, 0 is the oldest sample
+     * Description: Access a sample without removing it
+     *
+     ******************************/
+    const T& peek(uint8_t i) const{
+        uint8_t idx = head + i;
+
+        if(idx >= N){
+            idx -= N;
+        }
+        return buf[idx];
+    }
+
+    /******************************
+     *
+     * Name:        sample_ring::pop
+     * Returns:     Nothing
+     * Parameter:   Number of samples to remove
+     * Description: Remove the oldest n samples
+     *
+     ******************************/
+    void pop(uint8_t n){
+        if(n > count){
+            n = count;
+        }
+        head += n;
+        if(head >= N){
+            head -= N;
+        }
+        count -= n;
+    }
+};
+
+#endif
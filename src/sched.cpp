@@ -0,0 +1,370 @@
+/*******************************
+ *
+ * File: sched.cpp
+ *
+ * Low power scheduler. Instead of spinning in loop() until the next
+ * board task is due, the MCU is put into power-down and woken up by
+ * the watchdog timer. Incoming data on the hardware serial port or on
+ * the XBee soft serial port wakes the MCU early through the port D
+ * pin change interrupt.
+ *
+ * Timer0 is stopped in power-down, so the time spent sleeping is
+ * added back to the Arduino millis()/micros() counters after each
+ * wakeup to keep uptime correct. The watchdog oscillator is only
+ * good to about 10%, so its period is measured against Timer0
+ * every _SCHED_WDT_CAL_MS_, in place of one sleep. After an early
+ * wakeup the watchdog is left running to the end of its period,
+ * and the time still left of it tells how long we slept.
+ *
+ ******************************/
+
+#include "sched.h"
+#include "soft_uart.h"
+#include "adc_service.h"
+#include "log.h"
+#include <avr/sleep.h>
+#include <avr/wdt.h>
+#include <avr/interrupt.h>
+
+// Timer0 counters owned by the Arduino core (wiring.c)
+extern "C" {
+    extern volatile unsigned long timer0_millis;
+    extern volatile unsigned long timer0_overflow_count;
+}
+
+// Longest watchdog timeout (WDTO_8S)
+#define _SCHED_WDT_MAX_ 9
+
+// Sleeps shorter than the smallest watchdog timeout are done in idle
+#define _SCHED_WDT_MIN_MS_ 16
+
+// Watchdog timeout measured against Timer0 (WDTO_250MS, nominally
+// 256 ms), how often, and the range believed
+#define _SCHED_WDT_CAL_WDTO_ 4
+#define _SCHED_WDT_CAL_MS_ (1000UL*60*10)
+#define _SCHED_WDT_CAL_MIN_US_ 200000UL
+#define _SCHED_WDT_CAL_MAX_US_ 320000UL
+
+// Oscillator start-up after a wakeup from power-down, 16K CK with
+// the crystal fuse settings of every generation
+#define _SCHED_WAKE_US_ (16384UL / clockCyclesPerMicrosecond())
+
+static volatile uint8_t wdt_fired = 0;
+static volatile unsigned long wdt_fired_us;
+static unsigned long hold_start_ms = 0;
+static uint8_t hold_active = 0;
+
+static unsigned long wdt_cal_us = (unsigned long)_SCHED_WDT_MIN_MS_ * 1000 << _SCHED_WDT_CAL_WDTO_;
+static unsigned long wdt_cal_ms;
+static uint8_t wdt_cal_valid = 0;
+
+// Early wakeup still waiting for the watchdog to time out
+static volatile uint8_t wake_early = 0;
+static unsigned long wake_us;
+static uint8_t wake_wdto;
+
+// Sub-ms and sub-overflow parts of the credited time
+static unsigned long credit_ms_us = 0;
+static unsigned long credit_ovf_us = 0;
+
+static unsigned long sched_wdt_us(uint8_t wdto);
+static void sched_credit_us(unsigned long us);
+
+ISR(WDT_vect){
+    // One shot, the next sleep arms it again
+    WDTCSR &= ~_BV(WDIE);
+    wdt_fired_us = micros();
+    wdt_fired = 1;
+
+    // Woken up early: we slept for the part of the period
+    // that we weren't awake for
+    if(wake_early){
+        unsigned long period_us = sched_wdt_us(wake_wdto);
+        unsigned long awake_us = wdt_fired_us - wake_us;
+
+        if(awake_us < period_us){
+            sched_credit_us(period_us - awake_us);
+        }
+        wake_early = 0;
+    }
+}
+
+/******************************
+ *
+ * Name:        sched_wdt_ms
+ * Returns:     Nominal watchdog timeout in ms
+ * Parameter:   Watchdog prescaler setting (WDTO_*)
+ * Description: The watchdog runs from a 128kHz oscillator and
+ *              times out after 2K << wdto cycles.
+ *
+ ******************************/
+static unsigned long sched_wdt_ms(uint8_t wdto){
+    return (unsigned long)_SCHED_WDT_MIN_MS_ << wdto;
+}
+
+/******************************
+ *
+ * Name:        sched_wdt_us
+ * Returns:     Watchdog timeout in us
+ * Parameter:   Watchdog prescaler setting (WDTO_*)
+ * Description: Scaled from the last calibration
+ *
+ ******************************/
+static unsigned long sched_wdt_us(uint8_t wdto){
+    if(wdto >= _SCHED_WDT_CAL_WDTO_){
+        return wdt_cal_us << (wdto - _SCHED_WDT_CAL_WDTO_);
+    }
+    return wdt_cal_us >> (_SCHED_WDT_CAL_WDTO_ - wdto);
+}
+
+/******************************
+ *
+ * Name:        sched_credit_us
+ * Returns:     Nothing
+ * Parameter:   Time in us that the MCU was asleep
+ * Description: Advance the Arduino timekeeping counters by
+ *              the time spent in power-down. The parts too
+ *              small for a counter step are carried over to
+ *              the next credit.
+ *
+ ******************************/
+static void sched_credit_us(unsigned long us){
+    const unsigned long us_per_ovf = 64UL * 256UL / clockCyclesPerMicrosecond();
+    unsigned long n;
+    uint8_t old_sreg = SREG;
+
+    cli();
+    credit_ms_us += us;
+    n = credit_ms_us / 1000;
+    credit_ms_us -= n * 1000;
+    timer0_millis += n;
+
+    credit_ovf_us += us;
+    n = credit_ovf_us / us_per_ovf;
+    credit_ovf_us -= n * us_per_ovf;
+    timer0_overflow_count += n;
+    SREG = old_sreg;
+}
+
+/******************************
+ *
+ * Name:        sched_wdt_arm
+ * Returns:     Nothing
+ * Parameter:   Watchdog prescaler setting (WDTO_*)
+ * Description: Start the watchdog in interrupt mode. Call with
+ *              interrupts off.
+ *
+ ******************************/
+static void sched_wdt_arm(uint8_t wdto){
+    uint8_t wdp = (wdto & 0x07) | ((wdto & 0x08) ? _BV(WDP3) : 0);
+
+    wdt_fired = 0;
+    wdt_reset();
+    MCUSR &= ~_BV(WDRF);
+    WDTCSR = _BV(WDCE) | _BV(WDE);
+    WDTCSR = _BV(WDIE) | wdp;
+}
+
+/******************************
+ *
+ * Name:        sched_wdt_cal
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Time one watchdog period with Timer0, idling
+ *              meanwhile. Takes the place of one sleep.
+ *
+ ******************************/
+static void sched_wdt_cal(void){
+    unsigned long start_us;
+    unsigned long us;
+
+    cli();
+    sched_wdt_arm(_SCHED_WDT_CAL_WDTO_);
+    start_us = micros();
+    sei();
+
+    while(!wdt_fired){
+        sched_idle();
+    }
+
+    us = wdt_fired_us - start_us;
+    if(us >= _SCHED_WDT_CAL_MIN_US_ && us <= _SCHED_WDT_CAL_MAX_US_){
+        wdt_cal_us = us;
+    }
+    wdt_cal_ms = millis();
+    wdt_cal_valid = 1;
+}
+
+/******************************
+ *
+ * Name:        sched_idle
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Enter idle mode until the next interrupt. Timer0
+ *              and the UART keep running so no compensation
+ *              is needed.
+ *
+ ******************************/
+void sched_idle(void){
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    sleep_mode();
+}
+
+/******************************
+ *
+ * Name:        sched_power_down
+ * Returns:     Nothing
+ * Parameter:   Watchdog prescaler setting (WDTO_*)
+ * Description: Enter power-down until the watchdog times out or
+ *              a pin change interrupt wakes us up. Leaves the
+ *              time of the wakeup in wake_us.
+ *
+ ******************************/
+static void sched_power_down(uint8_t wdto){
+    uint8_t adcsra = ADCSRA;
+
+    // Make sure nothing is still being shifted out of the UART
+    Serial.flush();
+
+    // The ADC draws current even when idle
+    ADCSRA &= ~_BV(ADEN);
+
+    cli();
+    sched_wdt_arm(wdto);
+
+    set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+    sleep_enable();
+    sleep_bod_disable();
+    sei();
+    sleep_cpu();
+    wake_us = micros();
+    sleep_disable();
+
+    // The watchdog stops itself when it fires, after an early
+    // wakeup it is left running (see sched_sleep)
+    ADCSRA = adcsra;
+}
+
+/******************************
+ *
+ * Name:        sched_open
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Enable the pin change interrupt on the hardware
+ *              serial RX pin so console input wakes the MCU. The
+ *              XBee soft serial RX pin is already a pin change
+ *              interrupt on the same port.
+ *
+ ******************************/
+void sched_open(void){
+    PCMSK2 |= _BV(PCINT16);
+    PCICR |= _BV(PCIE2);
+}
+
+/******************************
+ *
+ * Name:        sched_sleep
+ * Returns:     Nothing
+ * Parameter:   Time in ms until the next board task is due
+ * Description: Sleep for at most sleep_ms. This sleeps for one
+ *              watchdog period (or one idle tick) and returns so
+ *              that the caller can poll the board tasks again.
+ *
+ ******************************/
+void sched_sleep(unsigned long sleep_ms){
+    uint8_t wdto = _SCHED_WDT_MAX_;
+
+    if(sleep_ms == 0){
+        return;
+    }
+
+    if(hold_active){
+        if(millis() - hold_start_ms < _SCHED_RX_HOLD_MS_){
+            sched_idle();
+            return;
+        }
+        hold_active = 0;
+    }
+
+    // Timer2 clocks the XBee soft UART and stops in power-down,
+    // power-down turns the ADC off, and log records still waiting
+    // for the serial port would sit there until the next wakeup.
+    // A watchdog still timing an early wakeup can't be rearmed.
+    if(sleep_ms < _SCHED_WDT_MIN_MS_ || Serial.available() || xbee_serial.busy() ||
+       adc_service_busy() || log_pending() || wake_early){
+        sched_idle();
+        return;
+    }
+
+    if(sleep_ms >= sched_wdt_ms(_SCHED_WDT_CAL_WDTO_) &&
+       (!wdt_cal_valid || millis() - wdt_cal_ms >= _SCHED_WDT_CAL_MS_)){
+        sched_wdt_cal();
+        return;
+    }
+
+    while(sched_wdt_us(wdto) / 1000 > sleep_ms && wdto > 0){
+        wdto--;
+    }
+
+    sched_power_down(wdto);
+
+    cli();
+    if(wdt_fired){
+        sched_credit_us(sched_wdt_us(wdto) + _SCHED_WAKE_US_);
+        sei();
+    }
+    else{
+        // Woken up early by incoming data. The watchdog interrupt
+        // credits the time asleep at the end of the period; stay
+        // awake for a while to receive the rest of the message.
+        wake_wdto = wdto;
+        wake_early = 1;
+        sei();
+        hold_start_ms = millis();
+        hold_active = 1;
+    }
+}
+
+/******************************
+ *
+ * Name:        sched_wait
+ * Returns:     Nothing
+ * Parameter:   Start time in ms, time to wait in ms
+ * Description: Idle until wait_ms have passed since start_ms.
+ *              Used instead of delay() while sensor
+ *              conversions are running.
+ *
+ ******************************/
+void sched_wait(unsigned long start_ms, unsigned long wait_ms){
+    while(millis() - start_ms < wait_ms){
+        sched_idle();
+    }
+}
+
+/******************************
+ *
+ * Name:        sched_conv_start
+ * Returns:     Nothing
+ * Parameter:   Conversion to track, conversion time in ms
+ * Description: Record that a conversion was just started
+ *
+ ******************************/
+void sched_conv_start(struct sched_conv* conv, uint8_t wait_ms){
+    conv->start_ms = millis();
+    conv->wait_ms = wait_ms;
+    conv->pending = 1;
+}
+
+/******************************
+ *
+ * Name:        sched_conv_wait
+ * Returns:     Nothing
+ * Parameter:   Conversion to wait for
+ * Description: Idle until the conversion is done and mark
+ *              it as collected
+ *
+ ******************************/
+void sched_conv_wait(struct sched_conv* conv){
+    sched_wait(conv->start_ms, conv->wait_ms);
+    conv->pending = 0;
+}
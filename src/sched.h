@@ -0,0 +1,32 @@
+/*******************************
+ *
+ * File: sched.h
+ *
+ * Contains prototypes for the low power scheduler that puts the
+ * MCU to sleep between board tasks.
+ *
+ ******************************/
+
+#include <Arduino.h>
+
+// Time to stay out of power-down after the MCU is woken by incoming
+// serial/XBee data, so the rest of the message can be received.
+#define _SCHED_RX_HOLD_MS_ 5000
+
+#ifndef SCHED_H
+#define SCHED_H
+
+// A sensor conversion that was started and is collected later
+struct sched_conv{
+    unsigned long start_ms;
+    uint8_t wait_ms;
+    uint8_t pending;
+};
+
+void sched_open(void);
+void sched_sleep(unsigned long sleep_ms);
+void sched_idle(void);
+void sched_wait(unsigned long start_ms, unsigned long wait_ms);
+void sched_conv_start(struct sched_conv* conv, uint8_t wait_ms);
+void sched_conv_wait(struct sched_conv* conv);
+#endif
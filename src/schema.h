@@ -0,0 +1,284 @@
+/*******************************
+ *
+ * File: schema.h
+ *
+ * Single source of every packet layout on the air. A schema is a
+ * list of fields in wire order, written as an X-macro taking two
+ * macros: F(type, name) for a scalar and A(type, name, count) for
+ * an array. Types are u8, u16, i16 and u32, little-endian with no
+ * padding.
+ *
+ * The firmware builds its packet structs, wire lengths and
+ * encoders from these lists:
+ *
+ *   struct gd_packet{ SCHEMA_STRUCT(SCHEMA_GD_FIELDS) };
+ *   SCHEMA_LEN(SCHEMA_GD_FIELDS)          Bytes on the wire
+ *   SCHEMA_WRITE(SCHEMA_GD_FIELDS)        Encode p into frame_writer w
+ *
+ * and the host decoder in utils/schema_decode builds its tables
+ * from the same lists (SCHEMA_LIST), so the two can't drift apart.
+ *
+ * Batches of samples can also go out delta coded, see
+ * SCHEMA_DELTA below.
+ *
+ * Schemas are versioned by number. A layout is never changed once
+ * it has been sent; add a field or reorder and it gets a new
+ * number. Only <stdint.h> is used, so the host can include this.
+ * Never reuse a number that was sent, even by old firmware.
+ *
+ ******************************/
+
+#include <stdint.h>
+
+// Schema numbers, the first u16 of every packet
+#define _SCHEMA_LEGACY_3_ 3
+#define _SCHEMA_LEGACY_7_ 7
+#define _SCHEMA_GA_ 10
+#define _SCHEMA_GC_ 11
+#define _SCHEMA_GD_ 12
+#define _SCHEMA_HEARTBEAT_ 13
+#define _SCHEMA_PROF_DIAG_ 0xFF01
+#define _SCHEMA_TIME_SYNC_ 0xFF02
+
+// Layouts of the baseline fleet, still sent by boxes that were
+// never upgraded. gd_3 and legacy_3 share number 3 and are told
+// apart by length.
+#define _SCHEMA_HEARTBEAT_0_ 0
+#define _SCHEMA_GA_1_ 1
+#define _SCHEMA_GC_2_ 2
+#define _SCHEMA_GD_3_ 3
+
+// Set in the schema number of a delta coded batch
+#define _SCHEMA_DELTA_ 0x8000
+
+#ifndef SCHEMA_H
+#define SCHEMA_H
+
+typedef uint8_t schema_u8;
+typedef uint16_t schema_u16;
+typedef int16_t schema_i16;
+typedef uint32_t schema_u32;
+
+// Heartbeat, sent alone in its frame
+#define SCHEMA_HEARTBEAT_FIELDS(F, A) \
+    SCHEMA_PACKET_HEADER(F, A) \
+    SCHEMA_HEARTBEAT_DATA(F, A)
+
+#define SCHEMA_HEARTBEAT_DATA(F, A) \
+    F(u16, batt_mv) \
+    F(u16, sample_s)            /* Sample period of the power policy */ \
+    F(u8,  tx_samples)          /* Samples per uplink */ \
+    F(u16, stack_max)           /* Deepest stack use since boot, bytes */ \
+    F(u16, free_min)            /* Smallest heap/stack gap, bytes */
+
+// Common start of every packet. uptime_ms and overflow_num are
+// the low 40 bits of the 64-bit uptime, see clock.h.
+#define SCHEMA_PACKET_HEADER(F, A) \
+    F(u16, schema) \
+    F(u16, node_addr) \
+    F(u32, uptime_ms) \
+    F(u8,  overflow_num)        /* Times uptime_ms wrapped */
+
+// Header of the baseline fleet, before overflow_num was added
+#define SCHEMA_PACKET_HEADER_0(F, A) \
+    F(u16, schema) \
+    F(u16, node_addr) \
+    F(u32, uptime_ms)
+
+// Baseline fleet, before the power policy and the window
+// statistics. Only decoded on the host.
+#define SCHEMA_HEARTBEAT_0_FIELDS(F, A) \
+    SCHEMA_PACKET_HEADER_0(F, A) \
+    F(u16, batt_mv)
+#define SCHEMA_GA_1_FIELDS(F, A) \
+    SCHEMA_PACKET_HEADER_0(F, A) \
+    SCHEMA_GA_1_DATA(F, A)
+#define SCHEMA_GC_2_FIELDS(F, A) \
+    SCHEMA_PACKET_HEADER_0(F, A) \
+    SCHEMA_GC_2_DATA(F, A)
+#define SCHEMA_GD_3_FIELDS(F, A) \
+    SCHEMA_PACKET_HEADER_0(F, A) \
+    SCHEMA_GD_3_DATA(F, A)
+
+// Apple
+#define SCHEMA_GA_FIELDS(F, A) \
+    SCHEMA_PACKET_HEADER(F, A) \
+    SCHEMA_GA_DATA(F, A)
+
+// apogee_w_m2 is the mean over the report window
+#define SCHEMA_GA_DATA(F, A) \
+    SCHEMA_GA_1_DATA(F, A) \
+    F(u16, apogee_min_w_m2) \
+    F(u16, apogee_max_w_m2) \
+    F(u32, apogee_var)          /* Variance, (W/m^2)^2 */
+
+#define SCHEMA_GA_1_DATA(F, A) \
+    F(u16, batt_mv) \
+    F(u16, panel_mv) \
+    F(u32, bmp085_press_pa) \
+    F(i16, bmp085_temp_decic) \
+    F(u16, humidity_centi_pct) \
+    F(u16, apogee_w_m2)
+
+// Cranberry
+#define SCHEMA_GC_FIELDS(F, A) \
+    SCHEMA_PACKET_HEADER(F, A) \
+    SCHEMA_GC_DATA(F, A)
+
+// apogee_w_m2 is the mean over the report window
+#define SCHEMA_GC_DATA(F, A) \
+    SCHEMA_GC_2_DATA(F, A) \
+    F(u16, apogee_min_w_m2) \
+    F(u16, apogee_max_w_m2) \
+    F(u32, apogee_var)          /* Variance, (W/m^2)^2 */
+
+#define SCHEMA_GC_2_DATA(F, A) \
+    F(u16, batt_mv) \
+    F(u16, panel_mv) \
+    F(u16, apogee_w_m2) \
+    F(u16, hih6131_temp_centik) \
+    F(u16, hih6131_humidity_pct) \
+    F(u32, mpl115a2t1_press_pa)
+
+// Dragonfruit
+#define SCHEMA_GD_FIELDS(F, A) \
+    SCHEMA_PACKET_HEADER(F, A) \
+    SCHEMA_GD_DATA(F, A)
+
+// apogee_sp215 is the mean over the report window
+#define SCHEMA_GD_DATA(F, A) \
+    SCHEMA_GD_3_DATA(F, A) \
+    F(u16, apogee_sp215_min) \
+    F(u16, apogee_sp215_max) \
+    F(u32, apogee_sp215_var)    /* Variance, mV^2 */
+
+#define SCHEMA_GD_3_DATA(F, A) \
+    F(u16, batt_mv) \
+    F(u16, panel_mv) \
+    F(u32, apogee_sp215) \
+    F(u16, mpl115a2t1_temp)     /* centiKelvin */ \
+    F(u16, hih6131_humidity_pct) \
+    F(u32, mpl115a2t1_press)    /* Pa */
+
+// Profiling stats, see prof.h. One entry per prof_id, in units
+// of _PROF_DIAG_UNIT_US_.
+#define SCHEMA_PROF_DIAG_FIELDS(F, A) \
+    F(u16, schema) \
+    F(u16, node_addr) \
+    A(u16, min, 12) \
+    A(u16, max, 12) \
+    A(u16, mean, 12)
+
+// Time sync, sent down from the gateway, see time_sync.h
+#define SCHEMA_TIME_SYNC_FIELDS(F, A) \
+    F(u16, schema) \
+    F(u32, epoch_s)             /* Unix time */ \
+    F(u16, epoch_ms)            /* 0..999 */
+
+// Legacy batched apple packets (tests/Transmit_Code/schema.h),
+// only decoded on the host
+#define SCHEMA_LEGACY_3_FIELDS(F, A) \
+    F(u16, schema) \
+    F(u16, address) \
+    F(u32, uptime_ms) \
+    F(u8,  overflow_num) \
+    F(u8,  n) \
+    A(u16, batt_mv, 6) \
+    A(u16, panel_mv, 6) \
+    F(u32, bmp085_press_pa) \
+    F(i16, bmp085_temp_decic) \
+    F(u16, humidity_centi_pct) \
+    A(u16, apogee_w_m2, 20)
+
+#define SCHEMA_LEGACY_7_FIELDS(F, A) \
+    SCHEMA_LEGACY_3_FIELDS(F, A) \
+    F(i16, dallas_roof_c)
+
+// Every schema: S(name, number, fields)
+#define SCHEMA_LIST(S) \
+    S(heartbeat_0, _SCHEMA_HEARTBEAT_0_, SCHEMA_HEARTBEAT_0_FIELDS) \
+    S(ga_1,        _SCHEMA_GA_1_,        SCHEMA_GA_1_FIELDS) \
+    S(gc_2,        _SCHEMA_GC_2_,        SCHEMA_GC_2_FIELDS) \
+    S(gd_3,        _SCHEMA_GD_3_,        SCHEMA_GD_3_FIELDS) \
+    S(legacy_3,    _SCHEMA_LEGACY_3_,    SCHEMA_LEGACY_3_FIELDS) \
+    S(legacy_7,    _SCHEMA_LEGACY_7_,    SCHEMA_LEGACY_7_FIELDS) \
+    S(ga,          _SCHEMA_GA_,          SCHEMA_GA_FIELDS) \
+    S(gc,          _SCHEMA_GC_,          SCHEMA_GC_FIELDS) \
+    S(gd,          _SCHEMA_GD_,          SCHEMA_GD_FIELDS) \
+    S(heartbeat,   _SCHEMA_HEARTBEAT_,   SCHEMA_HEARTBEAT_FIELDS) \
+    S(prof_diag,   _SCHEMA_PROF_DIAG_,   SCHEMA_PROF_DIAG_FIELDS) \
+    S(time_sync,   _SCHEMA_TIME_SYNC_,   SCHEMA_TIME_SYNC_FIELDS)
+
+// Struct members
+#define SCHEMA_STRUCT_F(type, name) schema_##type name;
+#define SCHEMA_STRUCT_A(type, name, count) schema_##type name[count];
+#define SCHEMA_STRUCT(fields) fields(SCHEMA_STRUCT_F, SCHEMA_STRUCT_A)
+
+// Wire length, a constant expression
+#define SCHEMA_LEN_F(type, name) + sizeof(schema_##type)
+#define SCHEMA_LEN_A(type, name, count) + (count) * sizeof(schema_##type)
+#define SCHEMA_LEN(fields) (0 fields(SCHEMA_LEN_F, SCHEMA_LEN_A))
+
+// Number of entries of a list
+#define SCHEMA_COUNT_F(type, name) + 1
+#define SCHEMA_COUNT_A(type, name, count) + 1
+#define SCHEMA_COUNT(fields) (0 fields(SCHEMA_COUNT_F, SCHEMA_COUNT_A))
+
+// Encoder body, writes the struct pointed to by p into the
+// frame_writer pointed to by w
+#define SCHEMA_WRITE_F(type, name) w->type(p->name);
+#define SCHEMA_WRITE_A(type, name, count) \
+    for(uint8_t i = 0; i < (count); i++){ w->type(p->name[i]); }
+#define SCHEMA_WRITE(fields) fields(SCHEMA_WRITE_F, SCHEMA_WRITE_A)
+
+// Delta coded batch of sample packets, one frame:
+//
+//   u16    schema | _SCHEMA_DELTA_
+//   u8     n, number of samples
+//   u32    epoch_s, Unix time of the first sample, 0 before the
+//          node got a time sync (see time_sync.h)
+//   u16    epoch_ms, 0..999
+//   varint zigzag(drift), ppm the node clock runs slow. Sample i
+//          was taken at epoch + t * (1 + drift / 10^6), t being its
+//          uptime less that of the first sample.
+//   ...    first sample, written in full
+//   n - 1 times:
+//     varint   zigzag(uptime step - previous uptime step), the
+//              first previous step being 0
+//     varint   zigzag(field - same field of the previous sample),
+//              for every field after the header, modulo the field
+//              width
+//
+// schema and node_addr are those of the first sample, overflow_num
+// goes up by one every time uptime_ms wraps. Varints are
+// LEB128, 7 bits a byte, low bits first. Every frame starts over
+// from a full sample, so a lost frame only loses its own samples.
+static inline int32_t schema_delta_u8(uint8_t a, uint8_t b){
+    return (int32_t)a - b;
+}
+
+static inline int32_t schema_delta_u16(uint16_t a, uint16_t b){
+    return (int16_t)(uint16_t)(a - b);
+}
+
+static inline int32_t schema_delta_i16(int16_t a, int16_t b){
+    return (int16_t)(uint16_t)(a - b);
+}
+
+static inline int32_t schema_delta_u32(uint32_t a, uint32_t b){
+    return (int32_t)(a - b);
+}
+
+static inline uint32_t schema_zigzag(int32_t v){
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+// Delta encoder body for the fields after the header, writes p
+// against prev into frame_writer w
+#define SCHEMA_DELTA_F(type, name) \
+    w->varint(schema_zigzag(schema_delta_##type(p->name, prev->name)));
+#define SCHEMA_DELTA_A(type, name, count) \
+    static_assert((count) == 0, "array fields can't be delta coded");
+#define SCHEMA_DELTA(fields) fields(SCHEMA_DELTA_F, SCHEMA_DELTA_A)
+
+#endif
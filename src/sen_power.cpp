@@ -0,0 +1,95 @@
+/*******************************
+ *
+ * File: sen_power.cpp
+ *
+ * Switched sensor supply. See sen_power.h.
+ *
+ ******************************/
+
+#include "sen_power.h"
+#include "sched.h"
+
+static int8_t sen_pin = -1;
+static uint8_t sen_on = 0;
+static unsigned long sen_on_ms;
+
+/******************************
+ *
+ * Name:        sen_power_open
+ * Returns:     Nothing
+ * Parameter:   Sensor enable pin, -1 if the board has none
+ * Description: Drive the pin, starting with the rail off
+ *
+ ******************************/
+void sen_power_open(int8_t pin){
+    sen_pin = pin;
+    if(sen_pin >= 0){
+        pinMode(sen_pin, OUTPUT);
+        digitalWrite(sen_pin, LOW);
+    }
+    sen_on = 0;
+}
+
+/******************************
+ *
+ * Name:        sen_power_on
+ * Returns:     1 if the rail was off, the drivers then need to
+ *              be re-initialized
+ * Parameter:   Nothing
+ * Description: Switch the rail on and start the warm-up
+ *
+ ******************************/
+uint8_t sen_power_on(void){
+    if(sen_pin < 0 || sen_on){
+        return 0;
+    }
+    digitalWrite(sen_pin, HIGH);
+    sen_on = 1;
+    sen_on_ms = millis();
+    return 1;
+}
+
+/******************************
+ *
+ * Name:        sen_power_off
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Cut the rail
+ *
+ ******************************/
+void sen_power_off(void){
+    if(sen_pin < 0){
+        return;
+    }
+    digitalWrite(sen_pin, LOW);
+    sen_on = 0;
+}
+
+/******************************
+ *
+ * Name:        sen_power_is_on
+ * Returns:     1 if the sensors are powered, always on boards
+ *              without the pin
+ * Parameter:   Nothing
+ * Description: Nothing
+ *
+ ******************************/
+uint8_t sen_power_is_on(void){
+    return sen_pin < 0 || sen_on;
+}
+
+/******************************
+ *
+ * Name:        sen_power_wait
+ * Returns:     Nothing
+ * Parameter:   Warm-up time, ms
+ * Description: Idle until the rail has been on for the warm-up
+ *              time. Returns at once if it already has.
+ *
+ ******************************/
+void sen_power_wait(unsigned long warmup_ms){
+    if(sen_pin < 0 || !sen_on){
+        return;
+    }
+    sched_wait(sen_on_ms, warmup_ms);
+}
@@ -0,0 +1,32 @@
+/*******************************
+ *
+ * File: sen_power.h
+ *
+ * Switched sensor supply. On boards with a sensor enable pin the
+ * rail is only on around sensor reads: board_core switches it on
+ * Traits::sen_warmup_ms ahead of each sample and irradiance
+ * reading, re-initializes the drivers that lose state with
+ * Traits::sen_power_up(), and cuts it again after the read.
+ *
+ * Each device declares how long it needs from power-on to a
+ * valid reading next to its driver, the board takes the largest
+ * of its devices on the rail (sen_power_max()). Boards without
+ * the pin (-1) are always powered and skip all of this.
+ *
+ ******************************/
+
+#include <Arduino.h>
+
+#ifndef SEN_POWER_H
+#define SEN_POWER_H
+
+static constexpr uint16_t sen_power_max(uint16_t a, uint16_t b){
+    return a > b ? a : b;
+}
+
+void sen_power_open(int8_t pin);
+uint8_t sen_power_on(void);
+void sen_power_off(void);
+uint8_t sen_power_is_on(void);
+void sen_power_wait(unsigned long warmup_ms);
+#endif
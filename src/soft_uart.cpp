@@ -0,0 +1,361 @@
+/*******************************
+ *
+ * File: soft_uart.cpp
+ *
+ * Timer2 based software UART, 8N1. See soft_uart.h.
+ *
+ * Timer2 runs free in normal mode. Each compare interrupt moves
+ * its compare register one bit time ahead, so the bit timing
+ * does not drift with interrupt latency.
+ *
+ ******************************/
+
+#include "soft_uart.h"
+#include <avr/interrupt.h>
+
+#define _SOFT_UART_TX_MASK_ (_SOFT_UART_TX_SIZE_ - 1)
+#define _SOFT_UART_RX_MASK_ (_SOFT_UART_RX_SIZE_ - 1)
+
+static_assert((_SOFT_UART_TX_SIZE_ & _SOFT_UART_TX_MASK_) == 0 && _SOFT_UART_TX_SIZE_ <= 256,
+              "_SOFT_UART_TX_SIZE_ must be a power of two");
+static_assert((_SOFT_UART_RX_SIZE_ & _SOFT_UART_RX_MASK_) == 0 && _SOFT_UART_RX_SIZE_ <= 256,
+              "_SOFT_UART_RX_SIZE_ must be a power of two");
+
+// TX state: next bit to send, 0 is the start bit, 1-8 data
+// bits, 9 the stop bit and 10 means the frame is done
+#define _SOFT_UART_TX_START_ 0
+#define _SOFT_UART_TX_STOP_ 9
+#define _SOFT_UART_TX_DONE_ 10
+
+// RX state: 0 idle, 1 checking the start bit, 2-9 data bits,
+// 10 stop bit
+#define _SOFT_UART_RX_IDLE_ 0
+#define _SOFT_UART_RX_START_ 1
+#define _SOFT_UART_RX_STOP_ 10
+
+soft_uart xbee_serial;
+
+// Timer2 prescalers, smallest first, and their CS2 bits
+static const uint8_t presc_div[] = {8, 32, 64};
+static const uint8_t presc_cs[] = {_BV(CS21), _BV(CS21) | _BV(CS20), _BV(CS22)};
+
+static uint8_t bit_ticks;
+static uint8_t half_ticks;
+
+static volatile uint8_t* tx_port;
+static uint8_t tx_mask;
+static uint8_t tx_buf[_SOFT_UART_TX_SIZE_];
+static volatile uint8_t tx_head;
+static volatile uint8_t tx_tail;
+static volatile uint8_t tx_active;
+static uint8_t tx_state;
+static uint8_t tx_byte;
+
+static volatile uint8_t* rx_in;
+static uint8_t rx_mask;
+static volatile uint8_t* rx_pcmsk;
+static uint8_t rx_pcmsk_bit;
+static uint8_t rx_buf[_SOFT_UART_RX_SIZE_];
+static volatile uint8_t rx_head;
+static volatile uint8_t rx_tail;
+static volatile uint8_t rx_state;
+static volatile uint8_t rx_overflow;
+static uint8_t rx_byte;
+static void (*volatile rx_handler)(uint8_t);
+
+/******************************
+ *
+ * Name:        rx_done
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Stop sampling and wait for the next start bit
+ *
+ ******************************/
+static inline void rx_done(void){
+    TIMSK2 &= ~_BV(OCIE2B);
+    rx_state = _SOFT_UART_RX_IDLE_;
+    *rx_pcmsk |= rx_pcmsk_bit;
+}
+
+// Start bit edge. Also runs for other port D pins (the scheduler
+// wakes on console RX through this vector), so check the pin.
+ISR(PCINT2_vect){
+    if(rx_state != _SOFT_UART_RX_IDLE_ || !(*rx_pcmsk & rx_pcmsk_bit)){
+        return;
+    }
+    if(*rx_in & rx_mask){
+        return;
+    }
+
+    // Sample in the middle of each bit, starting half a bit
+    // from the falling edge
+    OCR2B = TCNT2 + half_ticks;
+    TIFR2 = _BV(OCF2B);
+    TIMSK2 |= _BV(OCIE2B);
+    *rx_pcmsk &= ~rx_pcmsk_bit;
+    rx_state = _SOFT_UART_RX_START_;
+}
+
+ISR(TIMER2_COMPB_vect){
+    uint8_t high = *rx_in & rx_mask;
+    uint8_t state = rx_state;
+
+    OCR2B += bit_ticks;
+
+    if(state == _SOFT_UART_RX_START_){
+        // Glitch, not a start bit
+        if(high){
+            rx_done();
+            return;
+        }
+        rx_byte = 0;
+    }
+    else if(state < _SOFT_UART_RX_STOP_){
+        rx_byte >>= 1;
+        if(high){
+            rx_byte |= 0x80;
+        }
+    }
+    else{
+        // Keep the byte only if the stop bit is valid
+        if(high){
+            uint8_t next = (rx_head + 1) & _SOFT_UART_RX_MASK_;
+            void (*handler)(uint8_t) = rx_handler;
+
+            // Re-arm for the next start bit first, the handler
+            // runs well inside the stop bit
+            if(handler){
+                rx_done();
+                handler(rx_byte);
+                return;
+            }
+            if(next != rx_tail){
+                rx_buf[rx_head] = rx_byte;
+                rx_head = next;
+            }
+            else{
+                rx_overflow = 1;
+            }
+        }
+        rx_done();
+        return;
+    }
+    rx_state = state + 1;
+}
+
+ISR(TIMER2_COMPA_vect){
+    uint8_t state = tx_state;
+
+    OCR2A += bit_ticks;
+
+    if(state == _SOFT_UART_TX_DONE_){
+        if(tx_head == tx_tail){
+            TIMSK2 &= ~_BV(OCIE2A);
+            tx_active = 0;
+            return;
+        }
+        tx_byte = tx_buf[tx_tail];
+        tx_tail = (tx_tail + 1) & _SOFT_UART_TX_MASK_;
+        state = _SOFT_UART_TX_START_;
+    }
+
+    if(state == _SOFT_UART_TX_START_){
+        *tx_port &= ~tx_mask;
+    }
+    else if(state < _SOFT_UART_TX_STOP_){
+        if(tx_byte & 0x01){
+            *tx_port |= tx_mask;
+        }
+        else{
+            *tx_port &= ~tx_mask;
+        }
+        tx_byte >>= 1;
+    }
+    else{
+        *tx_port |= tx_mask;
+    }
+    tx_state = state + 1;
+}
+
+/******************************
+ *
+ * Name:        soft_uart::begin
+ * Returns:     Nothing
+ * Parameter:   Baud rate, RX pin (port D), TX pin
+ * Description: Configure the pins and start Timer2. The
+ *              prescaler is the smallest one that fits a bit
+ *              time in the 8 bit timer, e.g. 9600 to 57600 baud
+ *              use /8 at 16 MHz.
+ *
+ ******************************/
+void soft_uart::begin(unsigned long baud, uint8_t rx_pin, uint8_t tx_pin){
+    unsigned long ticks = 0;
+    uint8_t i;
+    uint8_t old_sreg;
+
+    for(i = 0; i < sizeof(presc_div); i++){
+        ticks = (F_CPU / presc_div[i] + baud / 2) / baud;
+        if(ticks < 256){
+            break;
+        }
+    }
+    if(i == sizeof(presc_div)){
+        i--;
+        ticks = 255;
+    }
+    bit_ticks = ticks;
+    half_ticks = ticks / 2;
+
+    // TX idles high
+    digitalWrite(tx_pin, HIGH);
+    pinMode(tx_pin, OUTPUT);
+    tx_port = portOutputRegister(digitalPinToPort(tx_pin));
+    tx_mask = digitalPinToBitMask(tx_pin);
+
+    pinMode(rx_pin, INPUT_PULLUP);
+    rx_in = portInputRegister(digitalPinToPort(rx_pin));
+    rx_mask = digitalPinToBitMask(rx_pin);
+    rx_pcmsk = digitalPinToPCMSK(rx_pin);
+    rx_pcmsk_bit = _BV(digitalPinToPCMSKbit(rx_pin));
+
+    old_sreg = SREG;
+    cli();
+    tx_head = tx_tail = 0;
+    rx_head = rx_tail = 0;
+    tx_active = 0;
+    rx_state = _SOFT_UART_RX_IDLE_;
+    rx_overflow = 0;
+
+    TIMSK2 &= ~(_BV(OCIE2A) | _BV(OCIE2B) | _BV(TOIE2));
+    TCCR2A = 0;
+    TCCR2B = presc_cs[i];
+
+    *rx_pcmsk |= rx_pcmsk_bit;
+    PCICR |= _BV(digitalPinToPCICRbit(rx_pin));
+    SREG = old_sreg;
+}
+
+/******************************
+ *
+ * Name:        soft_uart::end
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Send what is queued, then stop Timer2 and RX
+ *
+ ******************************/
+void soft_uart::end(void){
+    flush();
+    TIMSK2 &= ~(_BV(OCIE2A) | _BV(OCIE2B));
+    TCCR2B = 0;
+    *rx_pcmsk &= ~rx_pcmsk_bit;
+    rx_state = _SOFT_UART_RX_IDLE_;
+}
+
+/******************************
+ *
+ * Name:        soft_uart::busy
+ * Returns:     1 while a byte is being sent or received
+ * Parameter:   Nothing
+ * Description: Used by the scheduler to stay out of
+ *              power-down, where Timer2 does not run
+ *
+ ******************************/
+uint8_t soft_uart::busy(void){
+    return tx_active || rx_state != _SOFT_UART_RX_IDLE_;
+}
+
+/******************************
+ *
+ * Name:        soft_uart::overflow
+ * Returns:     1 if received bytes were dropped since the
+ *              last call
+ * Parameter:   Nothing
+ * Description: Reading clears the flag
+ *
+ ******************************/
+uint8_t soft_uart::overflow(void){
+    uint8_t ret = rx_overflow;
+    rx_overflow = 0;
+    return ret;
+}
+
+/******************************
+ *
+ * Name:        soft_uart::set_rx_handler
+ * Returns:     Nothing
+ * Parameter:   Function called with each received byte, NULL
+ *              to use the RX ring buffer again
+ * Description: The handler runs in the RX interrupt, so it must
+ *              be short (well under half a bit time)
+ *
+ ******************************/
+void soft_uart::set_rx_handler(void (*handler)(uint8_t)){
+    rx_handler = handler;
+}
+
+int soft_uart::available(void){
+    return (uint8_t)(rx_head - rx_tail) & _SOFT_UART_RX_MASK_;
+}
+
+int soft_uart::read(void){
+    uint8_t b;
+
+    if(rx_head == rx_tail){
+        return -1;
+    }
+    b = rx_buf[rx_tail];
+    rx_tail = (rx_tail + 1) & _SOFT_UART_RX_MASK_;
+    return b;
+}
+
+int soft_uart::peek(void){
+    if(rx_head == rx_tail){
+        return -1;
+    }
+    return rx_buf[rx_tail];
+}
+
+/******************************
+ *
+ * Name:        soft_uart::flush
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Wait until every queued byte has been sent
+ *
+ ******************************/
+void soft_uart::flush(void){
+    while(tx_active);
+}
+
+/******************************
+ *
+ * Name:        soft_uart::write
+ * Returns:     Number of bytes queued (1)
+ * Parameter:   Byte to send
+ * Description: Queue a byte. Only waits if the TX ring is
+ *              full.
+ *
+ ******************************/
+size_t soft_uart::write(uint8_t b){
+    uint8_t next = (tx_head + 1) & _SOFT_UART_TX_MASK_;
+    uint8_t old_sreg;
+
+    while(next == tx_tail);
+
+    tx_buf[tx_head] = b;
+    tx_head = next;
+
+    old_sreg = SREG;
+    cli();
+    if(!tx_active){
+        // Let the compare interrupt load the byte a few ticks
+        // from now
+        tx_active = 1;
+        tx_state = _SOFT_UART_TX_DONE_;
+        OCR2A = TCNT2 + 4;
+        TIFR2 = _BV(OCF2A);
+        TIMSK2 |= _BV(OCIE2A);
+    }
+    SREG = old_sreg;
+    return 1;
+}
@@ -0,0 +1,54 @@
+/*******************************
+ *
+ * File: soft_uart.h
+ *
+ * Interrupt driven software UART used as the XBee transport.
+ *
+ * Unlike SoftwareSerial, which bit-bangs every byte with
+ * interrupts disabled, bits are clocked by Timer2 compare
+ * interrupts: OCR2A shifts out the TX ring buffer and OCR2B
+ * samples RX after a pin change interrupt on the start bit.
+ * write() only queues the byte, so a whole XBee frame is queued
+ * in a few hundred cycles, and RX keeps working while a frame
+ * is being sent.
+ *
+ * Received bytes go into the RX ring buffer, or, if an RX
+ * handler is set, straight to the handler from the interrupt
+ * (the XBee frame parser uses this).
+ *
+ * Limitations: there is one instance (Timer2 and the port D pin
+ * change interrupt are owned by it), the RX pin must be on port D
+ * (digital pins 0-7), and Timer2 stops in power-down, so the
+ * scheduler only powers down when busy() is false.
+ *
+ ******************************/
+
+#include <Arduino.h>
+
+// Ring buffer sizes, must be powers of two. The TX buffer holds a
+// complete XBee frame so that XBee::send() never has to wait.
+#define _SOFT_UART_TX_SIZE_ 128
+#define _SOFT_UART_RX_SIZE_ 64
+
+#ifndef SOFT_UART_H
+#define SOFT_UART_H
+
+class soft_uart : public Stream{
+public:
+    void begin(unsigned long baud, uint8_t rx_pin, uint8_t tx_pin);
+    void end(void);
+    uint8_t busy(void);
+    uint8_t overflow(void);
+    void set_rx_handler(void (*handler)(uint8_t));
+
+    virtual int available(void);
+    virtual int read(void);
+    virtual int peek(void);
+    virtual void flush(void);
+    virtual size_t write(uint8_t b);
+    using Print::write;
+};
+
+extern soft_uart xbee_serial;
+
+#endif
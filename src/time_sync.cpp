@@ -0,0 +1,124 @@
+/*******************************
+ *
+ * File: time_sync.cpp
+ *
+ * Wall clock time from the coordinator. See time_sync.h.
+ *
+ ******************************/
+
+#include "time_sync.h"
+#include "clock.h"
+#include "schema.h"
+#include "log.h"
+
+static uint8_t synced = 0;
+static uint64_t ref_clock_ms;       // Local clock at the last sync
+static uint64_t ref_epoch_ms;       // Epoch at the last sync
+static int32_t drift_ppm = 0;       // Epoch ms gained per 10^6 local ms
+static uint8_t drift_valid = 0;
+
+/******************************
+ *
+ * Name:        time_sync_rx
+ * Returns:     1 if the payload was a time sync message
+ * Parameter:   ZB RX payload, its length, millis() when the frame
+ *              came in
+ * Description: Called by the XBee device layer for every payload
+ *              it receives. Takes the new epoch, and the drift of
+ *              the local clock since the previous sync.
+ *
+ ******************************/
+uint8_t time_sync_rx(const uint8_t* data, uint8_t len, unsigned long rx_ms){
+    uint64_t now;
+    uint64_t epoch;
+    uint8_t i;
+
+    if(len != SCHEMA_LEN(SCHEMA_TIME_SYNC_FIELDS) ||
+       (data[0] | data[1] << 8) != _SCHEMA_TIME_SYNC_){
+        return 0;
+    }
+
+    // epoch_s, then the ms part
+    epoch = 0;
+    for(i = 0; i < 4; i++){
+        epoch |= (uint32_t)data[2 + i] << (8 * i);
+    }
+    epoch = epoch * 1000 + (data[6] | data[7] << 8);
+    now = clock_ms() - (millis() - rx_ms);
+
+    if(synced && now - ref_clock_ms >= _TIME_SYNC_DRIFT_MIN_MS_){
+        int64_t elapsed = now - ref_clock_ms;
+        int64_t ppm = ((int64_t)(epoch - ref_epoch_ms) - elapsed) * 1000000 / elapsed;
+
+        // Average out the receive latency of single syncs
+        if(ppm > -_TIME_SYNC_DRIFT_MAX_PPM_ && ppm < _TIME_SYNC_DRIFT_MAX_PPM_){
+            drift_ppm += drift_valid ? (ppm - drift_ppm) / 4 : ppm;
+            drift_valid = 1;
+        }
+    }
+
+    if(!synced || now - ref_clock_ms >= _TIME_SYNC_DRIFT_MIN_MS_){
+        ref_clock_ms = now;
+        ref_epoch_ms = epoch;
+    }
+    else{
+        // Too soon for a drift update, keep the reference so the
+        // interval keeps growing, only step the offset
+        ref_epoch_ms = epoch - (now - ref_clock_ms) -
+                       (int64_t)(now - ref_clock_ms) * drift_ppm / 1000000;
+    }
+    synced = 1;
+
+    // Logged as s16, the drift of a working clock is far inside it
+    print_log(_LOG_INFO_, LOG_TIME_SYNC,
+              (uint16_t)(drift_ppm > INT16_MAX ? INT16_MAX :
+                         drift_ppm < INT16_MIN ? INT16_MIN : drift_ppm));
+    return 1;
+}
+
+/******************************
+ *
+ * Name:        time_sync_valid
+ * Returns:     1 once a time sync was received
+ * Parameter:   Nothing
+ * Description: Before that there is no epoch to give
+ *
+ ******************************/
+uint8_t time_sync_valid(void){
+    return synced;
+}
+
+/******************************
+ *
+ * Name:        time_sync_epoch_ms
+ * Returns:     Unix time in ms, 0 before the first sync
+ * Parameter:   Time on the local clock, see clock_ms()
+ * Description: Map a local time, past or future, to the epoch,
+ *              correcting for the drift
+ *
+ ******************************/
+uint64_t time_sync_epoch_ms(uint64_t local_ms){
+    int64_t elapsed;
+
+    if(!synced){
+        return 0;
+    }
+    elapsed = (int64_t)(local_ms - ref_clock_ms);
+    return ref_epoch_ms + elapsed + elapsed * drift_ppm / 1000000;
+}
+
+/******************************
+ *
+ * Name:        time_sync_local_ms
+ * Returns:     The same span on the local clock
+ * Parameter:   Span of Unix time, ms
+ * Description: Used to wait for a given Unix time
+ *
+ ******************************/
+unsigned long time_sync_local_ms(unsigned long epoch_ms){
+    return (int64_t)epoch_ms * 1000000 / (1000000 + drift_ppm);
+}
+
+int32_t time_sync_drift_ppm(void){
+    return drift_ppm;
+}
@@ -0,0 +1,38 @@
+/*******************************
+ *
+ * File: time_sync.h
+ *
+ * Wall clock time from the coordinator. The gateway sends a time
+ * sync message (SCHEMA_TIME_SYNC_FIELDS in schema.h, Unix time to
+ * the ms) down to the node, best as the reply to an uplink since the
+ * radio sleeps otherwise. The node keeps the epoch of the last
+ * sync against its own monotonic clock (clock.h) and corrects for
+ * the drift of that clock, measured between syncs. Power-down is
+ * timed by the watchdog, calibrated against the CPU clock (see
+ * sched.cpp), so the drift is that of the CPU clock plus what the
+ * watchdog wanders between calibrations.
+ *
+ * Samples keep their uptime; the epoch is only worked out when a
+ * batch is sent, so samples taken before the first sync still get
+ * the right time.
+ *
+ ******************************/
+
+#include <Arduino.h>
+
+// Syncs closer together than this don't update the drift, the
+// receive latency would dominate it
+#define _TIME_SYNC_DRIFT_MIN_MS_ (1000UL*60*10)
+
+// Largest drift believed, in ppm
+#define _TIME_SYNC_DRIFT_MAX_PPM_ 200000L
+
+#ifndef TIME_SYNC_H
+#define TIME_SYNC_H
+
+uint8_t time_sync_rx(const uint8_t* data, uint8_t len, unsigned long rx_ms);
+uint8_t time_sync_valid(void);
+uint64_t time_sync_epoch_ms(uint64_t clock_ms);
+unsigned long time_sync_local_ms(unsigned long epoch_ms);
+int32_t time_sync_drift_ppm(void);
+#endif
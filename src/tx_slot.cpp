@@ -0,0 +1,67 @@
+/*******************************
+ *
+ * File: tx_slot.cpp
+ *
+ * Uplink slots. See tx_slot.h.
+ *
+ ******************************/
+
+#include "tx_slot.h"
+#include "time_sync.h"
+
+static uint8_t slot = 0;
+
+/******************************
+ *
+ * Name:        tx_slot_open
+ * Returns:     Nothing
+ * Parameter:   Node address
+ * Description: Pick the slot of the node. The address also seeds
+ *              random(), so nodes that boot together draw
+ *              different periods before the first time sync.
+ *
+ ******************************/
+void tx_slot_open(uint16_t node_addr){
+    slot = node_addr % _TX_SLOT_COUNT_;
+    randomSeed(node_addr);
+}
+
+/******************************
+ *
+ * Name:        tx_slot_offset
+ * Returns:     Offset of the node's slot into the period, ms
+ * Parameter:   Period, ms
+ * Description: Nothing
+ *
+ ******************************/
+unsigned long tx_slot_offset(unsigned long period_ms){
+    return ((unsigned long)slot * _TX_SLOT_MS_) % period_ms;
+}
+
+/******************************
+ *
+ * Name:        tx_slot_next
+ * Returns:     Time of the next slot on the local clock
+ * Parameter:   Local time now (clock_ms()), period, ms
+ * Description: With a time sync, the next time the Unix time is
+ *              the slot offset into a period, at least one slot
+ *              away so a slot isn't taken twice. Without, one
+ *              period from now give or take the random jitter.
+ *
+ ******************************/
+uint64_t tx_slot_next(uint64_t now, unsigned long period_ms){
+    unsigned long jitter_ms = period_ms / _TX_SLOT_JITTER_DIV_;
+    unsigned long phase_ms;
+    unsigned long wait_ms;
+
+    if(!time_sync_valid()){
+        return now + period_ms - jitter_ms + random(2 * jitter_ms + 1);
+    }
+
+    phase_ms = time_sync_epoch_ms(now) % period_ms;
+    wait_ms = (tx_slot_offset(period_ms) + period_ms - phase_ms) % period_ms;
+    if(wait_ms < _TX_SLOT_MS_){
+        wait_ms += period_ms;
+    }
+    return now + time_sync_local_ms(wait_ms);
+}
@@ -0,0 +1,37 @@
+/*******************************
+ *
+ * File: tx_slot.h
+ *
+ * Uplink slots. Every node gets a fixed offset into the sample
+ * period from its node address, _TX_SLOT_MS_ apart, and samples
+ * (and so transmits) at that offset. Once the node has a time
+ * sync the slots are on Unix time, so the nodes of a network take
+ * turns on the channel instead of all sending at once after they
+ * power up together. The sample periods of the power policy are
+ * multiples of 15 s, so nodes on different periods keep their
+ * slots apart too.
+ *
+ * Before the first sync there is no common time; each period is
+ * then drawn at random within +/- 1/_TX_SLOT_JITTER_DIV_ of its
+ * length, which spreads nodes that booted together within a few
+ * periods.
+ *
+ ******************************/
+
+#include <Arduino.h>
+
+// Slot width and number of slots. Addresses that are equal
+// modulo _TX_SLOT_COUNT_ share a slot.
+#define _TX_SLOT_MS_ 200
+#define _TX_SLOT_COUNT_ 64
+
+// Random period fallback, +/- 1/8 of the period
+#define _TX_SLOT_JITTER_DIV_ 8
+
+#ifndef TX_SLOT_H
+#define TX_SLOT_H
+
+void tx_slot_open(uint16_t node_addr);
+unsigned long tx_slot_offset(unsigned long period_ms);
+uint64_t tx_slot_next(uint64_t now, unsigned long period_ms);
+#endif
@@ -0,0 +1,105 @@
+/*******************************
+ *
+ * File: window_stats.h
+ *
+ * Streaming min, max, mean and variance of a sensor sampled
+ * many times per report window, so that only the summary has
+ * to be sent. Integer only: the running mean is kept in Q8 and
+ * the sum of squared deviations (Welford's M2) in Q16, which
+ * avoids the cancellation of a sum of squares.
+ *
+ ******************************/
+
+#include <Arduino.h>
+
+#ifndef WINDOW_STATS_H
+#define WINDOW_STATS_H
+
+struct window_stats{
+    uint16_t n;
+    uint16_t lo;
+    uint16_t hi;
+    int32_t mean_q8;
+    int64_t m2_q16;
+
+    /******************************
+     *
+     * Name:        window_stats::clear
+     * Returns:     Nothing
+     * Parameter:   Nothing
+     * Description: Start a new window
+     *
+     ******************************/
+    void clear(void){
+        n = 0;
+        lo = 0;
+        hi = 0;
+        mean_q8 = 0;
+        m2_q16 = 0;
+    }
+
+    /******************************
+     *
+     * Name:        window_stats::add
+     * Returns:     Nothing
+     * Parameter:   New reading
+     * Description: Welford update of the mean and M2
+     *
+     ******************************/
+    void add(uint16_t x){
+        int32_t x_q8 = (int32_t)x << 8;
+        int32_t delta;
+
+        if(n == 0xFFFF){
+            return;
+        }
+        if(n++ == 0){
+            lo = hi = x;
+            mean_q8 = x_q8;
+            m2_q16 = 0;
+            return;
+        }
+        if(x < lo){
+            lo = x;
+        }
+        if(x > hi){
+            hi = x;
+        }
+
+        delta = x_q8 - mean_q8;
+        mean_q8 += delta / (int32_t)n;
+        m2_q16 += (int64_t)delta * (x_q8 - mean_q8);
+    }
+
+    /******************************
+     *
+     * Name:        window_stats::mean
+     * Returns:     Mean of the window, rounded
+     * Parameter:   Nothing
+     * Description: Nothing
+     *
+     ******************************/
+    uint16_t mean(void) const{
+        return (mean_q8 + 0x80) >> 8;
+    }
+
+    /******************************
+     *
+     * Name:        window_stats::variance
+     * Returns:     Population variance of the window, rounded
+     * Parameter:   Nothing
+     * Description: 0 for fewer than two readings
+     *
+     ******************************/
+    uint32_t variance(void) const{
+        int64_t var_q16;
+
+        if(n < 2 || m2_q16 <= 0){
+            return 0;
+        }
+        var_q16 = m2_q16 / n;
+        return (uint32_t)((var_q16 + 0x8000) >> 16);
+    }
+};
+
+#endif
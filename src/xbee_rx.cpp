@@ -0,0 +1,186 @@
+/*******************************
+ *
+ * File: xbee_rx.cpp
+ *
+ * XBee API frame parser feeding a fixed frame queue. See
+ * xbee_rx.h. Frame format:
+ *
+ *   0x7E, length MSB, length LSB, frame data..., checksum
+ *
+ * Every byte after the start delimiter may be escaped (0x7D,
+ * then the byte XOR 0x20). The checksum makes the sum of the
+ * frame data and the checksum 0xFF.
+ *
+ ******************************/
+
+#include "xbee_rx.h"
+#include "soft_uart.h"
+
+#define _XBEE_RX_START_ 0x7E
+#define _XBEE_RX_ESCAPE_ 0x7D
+#define _XBEE_RX_XOR_ 0x20
+
+enum xbee_rx_state{
+    XBEE_RX_WAIT_START,
+    XBEE_RX_LEN_MSB,
+    XBEE_RX_LEN_LSB,
+    XBEE_RX_DATA,
+    XBEE_RX_CHECKSUM
+};
+
+// Written by the ISR at head, read by the main loop at tail
+static struct xbee_rx_frame queue[_XBEE_RX_QUEUE_LEN_];
+static volatile uint8_t queue_head = 0;
+static volatile uint8_t queue_count = 0;
+static uint8_t queue_tail = 0;
+
+static uint8_t state = XBEE_RX_WAIT_START;
+static uint8_t escaped = 0;
+static uint16_t frame_len = 0;
+static uint8_t frame_pos = 0;
+static uint8_t checksum = 0;
+static uint8_t discard = 0;             // Frame doesn't fit, parse and drop it
+static volatile uint8_t dropped = 0;
+
+/******************************
+ *
+ * Name:        xbee_rx_byte
+ * Returns:     Nothing
+ * Parameter:   Received byte
+ * Description: Parser state machine, called from the soft
+ *              UART RX interrupt
+ *
+ ******************************/
+static void xbee_rx_byte(uint8_t b){
+    struct xbee_rx_frame* f = &queue[queue_head];
+
+    // A start delimiter always starts a new frame, even in
+    // the middle of a broken one
+    if(b == _XBEE_RX_START_){
+        state = XBEE_RX_LEN_MSB;
+        escaped = 0;
+        return;
+    }
+    if(state == XBEE_RX_WAIT_START){
+        return;
+    }
+    if(b == _XBEE_RX_ESCAPE_){
+        escaped = 1;
+        return;
+    }
+    if(escaped){
+        b ^= _XBEE_RX_XOR_;
+        escaped = 0;
+    }
+
+    switch(state){
+        case XBEE_RX_LEN_MSB:
+            frame_len = (uint16_t)b << 8;
+            state = XBEE_RX_LEN_LSB;
+            break;
+        case XBEE_RX_LEN_LSB:
+            frame_len |= b;
+            frame_pos = 0;
+            checksum = 0;
+            discard = frame_len > _XBEE_RX_FRAME_MAX_ ||
+                      queue_count >= _XBEE_RX_QUEUE_LEN_;
+            state = frame_len ? XBEE_RX_DATA : XBEE_RX_WAIT_START;
+            break;
+        case XBEE_RX_DATA:
+            if(!discard){
+                f->data[frame_pos] = b;
+            }
+            checksum += b;
+            if(++frame_pos >= frame_len){
+                state = XBEE_RX_CHECKSUM;
+            }
+            break;
+        case XBEE_RX_CHECKSUM:
+            checksum += b;
+            if(discard){
+                dropped++;
+            }
+            else if(checksum == 0xFF){
+                f->len = frame_len;
+                f->ms = millis();
+                if(++queue_head >= _XBEE_RX_QUEUE_LEN_){
+                    queue_head = 0;
+                }
+                queue_count++;
+            }
+            state = XBEE_RX_WAIT_START;
+            break;
+    }
+}
+
+/******************************
+ *
+ * Name:        xbee_rx_open
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Route the XBee soft UART RX bytes into the
+ *              parser. Call after xbee_serial.begin().
+ *
+ ******************************/
+void xbee_rx_open(void){
+    xbee_serial.set_rx_handler(xbee_rx_byte);
+}
+
+/******************************
+ *
+ * Name:        xbee_rx_peek
+ * Returns:     Oldest received frame, NULL if none
+ * Parameter:   Nothing
+ * Description: The frame stays valid until xbee_rx_pop()
+ *
+ ******************************/
+struct xbee_rx_frame* xbee_rx_peek(void){
+    if(queue_count == 0){
+        return NULL;
+    }
+    return &queue[queue_tail];
+}
+
+/******************************
+ *
+ * Name:        xbee_rx_pop
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Release the oldest received frame
+ *
+ ******************************/
+void xbee_rx_pop(void){
+    uint8_t old_sreg;
+
+    if(queue_count == 0){
+        return;
+    }
+    if(++queue_tail >= _XBEE_RX_QUEUE_LEN_){
+        queue_tail = 0;
+    }
+
+    old_sreg = SREG;
+    cli();
+    queue_count--;
+    SREG = old_sreg;
+}
+
+/******************************
+ *
+ * Name:        xbee_rx_dropped
+ * Returns:     Number of frames dropped because the queue was
+ *              full or they were too long, since the last call
+ * Parameter:   Nothing
+ * Description: Reading clears the count
+ *
+ ******************************/
+uint8_t xbee_rx_dropped(void){
+    uint8_t old_sreg = SREG;
+    uint8_t ret;
+
+    cli();
+    ret = dropped;
+    dropped = 0;
+    SREG = old_sreg;
+    return ret;
+}
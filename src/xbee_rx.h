@@ -0,0 +1,41 @@
+/*******************************
+ *
+ * File: xbee_rx.h
+ *
+ * XBee API frame receiver. Bytes from the XBee soft UART are
+ * parsed in the RX interrupt (escaped API mode, AP=2) and each
+ * frame with a valid checksum is put in a small fixed queue,
+ * so frames are not lost while the main loop is busy sampling.
+ * The device layer takes frames off the queue and dispatches
+ * them by API ID (data[0]).
+ *
+ ******************************/
+
+#include <Arduino.h>
+
+// Number of frames the queue holds and the largest frame data
+// (API ID and payload) kept. Longer frames are dropped.
+#define _XBEE_RX_QUEUE_LEN_ 4
+#define _XBEE_RX_FRAME_MAX_ 32
+
+// Offsets in the frame data
+#define _XBEE_RX_API_ID_ 0
+#define _XBEE_RX_ZB_DATA_ 12            // Payload of ZB_RX_RESPONSE
+#define _XBEE_RX_TX_FRAME_ID_ 1         // ZB_TX_STATUS_RESPONSE fields
+#define _XBEE_RX_TX_DELIVERY_ 5
+#define _XBEE_RX_MODEM_STATUS_ 1        // MODEM_STATUS_RESPONSE field
+
+#ifndef XBEE_RX_H
+#define XBEE_RX_H
+
+struct xbee_rx_frame{
+    uint8_t len;
+    unsigned long ms;           // millis() when the frame was complete
+    uint8_t data[_XBEE_RX_FRAME_MAX_];
+};
+
+void xbee_rx_open(void);
+struct xbee_rx_frame* xbee_rx_peek(void);
+void xbee_rx_pop(void);
+uint8_t xbee_rx_dropped(void);
+#endif
@@ -10,6 +10,8 @@
  *    Notes: When a new packet schema is made, create a new structure.
  *        BINARY packet is position dependent on where everything is placed
  *        and sent.
+ *        The host decoder reads schemas 3 and 7 from the
+ *        SCHEMA_LEGACY_*_FIELDS lists in src/schema.h, keep them in step.
  *
  ******************************************/
 
@@ -0,0 +1,223 @@
+/*******************************
+ *
+ * File: main.cpp
+ *
+ * sensor_kernels: check the integer sensor conversions against
+ * the float code they replaced, over the whole raw input range
+ * of each sensor and a few calibration sets. The libraries are
+ * built unchanged against mock Arduino, Wire and pin functions
+ * that hand back queued raw readings.
+ *
+ * Every result has to be within one LSB of the float result in
+ * the same unit. Exits non-zero if any is not.
+ *
+ ******************************/
+
+#include <SHT1x.h>
+#include <Adafruit_MPL115A2.h>
+#include <Adafruit_BMP085.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Sensor coefficients as they sit in the calibration registers
+struct mpl115a2_cal{
+    uint16_t a0, b1, b2, c12;
+};
+
+struct bmp085_cal{
+    int16_t ac1, ac2, ac3;
+    uint16_t ac4, ac5, ac6;
+    int16_t b1, b2, mb, mc, md;
+};
+
+// Datasheet example first, then spread around it
+static const struct mpl115a2_cal mpl115a2_cals[] = {
+    {0x3ECE, 0xB3F9, 0xC517, 0x33C8},
+    {0x4225, 0xAE6B, 0xC0A1, 0x3A74},
+    {0x3B1A, 0xB7D2, 0xC8C6, 0x2D30},
+};
+
+static const struct bmp085_cal bmp085_cals[] = {
+    {408, -72, -14383, 32741, 32757, 23153, 6190, 4, -32768, -8711, 2868},
+    {8012, -1147, -14407, 33868, 25087, 19107, 6515, 42, -32768, -11786, 2442},
+    {7264, -1213, -14483, 32975, 24421, 17612, 5498, 55, -32768, -11075, 2432},
+};
+
+struct result{
+    const char* name;
+    unsigned long n;
+    double max_err;
+};
+
+static int failed = 0;
+
+static void result_add(struct result* r, double fixed_val, double float_val){
+    double err = fabs(fixed_val - float_val);
+
+    r->n++;
+    if(err > r->max_err){
+        r->max_err = err;
+    }
+}
+
+static void result_print(const struct result* r){
+    int ok = r->max_err <= 1.0;
+
+    printf("%-28s %9lu inputs, max error %.3f LSB %s\n",
+           r->name, r->n, r->max_err, ok ? "ok" : "FAIL");
+    if(!ok){
+        failed = 1;
+    }
+}
+
+/******************************
+ *
+ * Name:        sht1x_push
+ * Returns:     Nothing
+ * Parameter:   Raw 16 bit measurement
+ * Description: Queue the pin levels of one SHT1x measurement:
+ *              command ack, conversion done, then the data
+ *              bits MSB first
+ *
+ ******************************/
+static void sht1x_push(uint16_t val){
+    int i;
+
+    mock_pin_push(LOW);
+    mock_pin_push(HIGH);
+    mock_pin_push(LOW);
+    for(i = 15; i >= 0; i--){
+        mock_pin_push((val >> i) & 1);
+    }
+}
+
+static void sht1x_test(void){
+    struct result r = {"SHT1x readHumidityCenti", 0, 0};
+    SHT1x sht1x(0, 1);
+    uint16_t val;
+    uint16_t tval;
+
+    // 12 bit humidity, 14 bit temperature (-40 to 123.8 C)
+    for(val = 0; val < 4096; val++){
+        for(tval = 0; tval < 16384; tval += 7){
+            float humidity;
+            int humidity_centi;
+
+            sht1x_push(val);
+            sht1x_push(tval);
+            humidity = sht1x.readHumidity();
+
+            sht1x_push(val);
+            sht1x_push(tval);
+            humidity_centi = sht1x.readHumidityCenti();
+
+            result_add(&r, humidity_centi, humidity * 100.0);
+        }
+    }
+    result_print(&r);
+}
+
+static void mpl115a2_push_raw(uint16_t pressure, uint16_t temp){
+    mock_wire_push(pressure >> 2);
+    mock_wire_push((pressure << 6) & 0xFF);
+    mock_wire_push(temp >> 2);
+    mock_wire_push((temp << 6) & 0xFF);
+}
+
+static void mpl115a2_test(void){
+    struct result rp = {"MPL115A2 readPTFixed P (Pa)", 0, 0};
+    struct result rt = {"MPL115A2 readPTFixed T (cC)", 0, 0};
+    unsigned int i;
+
+    for(i = 0; i < sizeof(mpl115a2_cals) / sizeof(mpl115a2_cals[0]); i++){
+        const struct mpl115a2_cal* cal = &mpl115a2_cals[i];
+        Adafruit_MPL115A2 mpl115a2;
+        uint16_t pressure;
+        uint16_t temp;
+
+        mock_wire_push(cal->a0 >> 8);
+        mock_wire_push(cal->a0 & 0xFF);
+        mock_wire_push(cal->b1 >> 8);
+        mock_wire_push(cal->b1 & 0xFF);
+        mock_wire_push(cal->b2 >> 8);
+        mock_wire_push(cal->b2 & 0xFF);
+        mock_wire_push(cal->c12 >> 8);
+        mock_wire_push(cal->c12 & 0xFF);
+        mpl115a2.begin();
+
+        // 10 bit pressure and temperature
+        for(pressure = 0; pressure < 1024; pressure++){
+            for(temp = 0; temp < 1024; temp++){
+                float p_kpa, t_c;
+                uint32_t p_pa;
+                int16_t t_centic;
+
+                mpl115a2_push_raw(pressure, temp);
+                mpl115a2.readPT(&p_kpa, &t_c);
+                mpl115a2_push_raw(pressure, temp);
+                mpl115a2.readPTFixed(&p_pa, &t_centic);
+
+                result_add(&rp, p_pa, p_kpa * 1000.0);
+                result_add(&rt, t_centic, t_c * 100.0);
+            }
+        }
+    }
+    result_print(&rp);
+    result_print(&rt);
+}
+
+static void bmp085_push16(uint16_t val){
+    mock_wire_push(val >> 8);
+    mock_wire_push(val & 0xFF);
+}
+
+static void bmp085_test(void){
+    struct result r = {"BMP085 computeTemperatureDeci", 0, 0};
+    unsigned int i;
+
+    for(i = 0; i < sizeof(bmp085_cals) / sizeof(bmp085_cals[0]); i++){
+        const struct bmp085_cal* cal = &bmp085_cals[i];
+        Adafruit_BMP085 bmp085;
+        long ut;
+
+        mock_wire_push(0x55);
+        bmp085_push16(cal->ac1);
+        bmp085_push16(cal->ac2);
+        bmp085_push16(cal->ac3);
+        bmp085_push16(cal->ac4);
+        bmp085_push16(cal->ac5);
+        bmp085_push16(cal->ac6);
+        bmp085_push16(cal->b1);
+        bmp085_push16(cal->b2);
+        bmp085_push16(cal->mb);
+        bmp085_push16(cal->mc);
+        bmp085_push16(cal->md);
+        if(!bmp085.begin()){
+            fprintf(stderr, "BMP085 begin failed\n");
+            exit(2);
+        }
+
+        // Datasheet temperature formula in float, in 0.1 C. Only
+        // the operating range (-40 to 85 C) counts, the formula
+        // has a pole outside of it.
+        for(ut = 0; ut < 65536; ut++){
+            double x1 = (ut - cal->ac6) * (double)cal->ac5 / 32768.0;
+            double x2 = cal->mc * 2048.0 / (x1 + cal->md);
+            double t_deci = (x1 + x2) / 16.0;
+
+            if(t_deci < -400.0 || t_deci > 850.0){
+                continue;
+            }
+            result_add(&r, bmp085.computeTemperatureDeci(ut), t_deci);
+        }
+    }
+    result_print(&r);
+}
+
+int main(void){
+    sht1x_test();
+    mpl115a2_test();
+    bmp085_test();
+
+    return failed;
+}
@@ -0,0 +1,34 @@
+/*******************************
+ *
+ * File: Arduino.h
+ *
+ * Just enough of the Arduino core to build the sensor libraries
+ * on the host. Pin reads come from a queue the test fills, see
+ * mock.cpp.
+ *
+ ******************************/
+
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+#include <stdint.h>
+#include <math.h>
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define MSBFIRST 1
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+void delay(unsigned long ms);
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+void shiftOut(uint8_t data_pin, uint8_t clock_pin, uint8_t order, uint8_t val);
+
+// Test side: queue levels for digitalRead()
+void mock_pin_push(uint8_t val);
+#endif
@@ -0,0 +1,29 @@
+/*******************************
+ *
+ * File: Wire.h
+ *
+ * Host stand-in for the Arduino I2C library. Writes are dropped,
+ * reads come from a queue the test fills, see mock.cpp.
+ *
+ ******************************/
+
+#ifndef WIRE_H
+#define WIRE_H
+
+#include "Arduino.h"
+
+class TwoWire{
+public:
+    void begin(void){}
+    void beginTransmission(int addr){ (void)addr; }
+    uint8_t endTransmission(void){ return 0; }
+    size_t write(uint8_t val){ (void)val; return 1; }
+    uint8_t requestFrom(int addr, int n){ (void)addr; return n; }
+    int read(void);
+};
+
+extern TwoWire Wire;
+
+// Test side: queue bytes for Wire.read()
+void mock_wire_push(uint8_t val);
+#endif
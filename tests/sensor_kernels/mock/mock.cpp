@@ -0,0 +1,35 @@
+#include "Arduino.h"
+#include "Wire.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <deque>
+
+TwoWire Wire;
+
+static std::deque<uint8_t> wire_queue;
+static std::deque<uint8_t> pin_queue;
+
+static uint8_t mock_pop(std::deque<uint8_t>& q, const char* what){
+    uint8_t val;
+
+    if(q.empty()){
+        fprintf(stderr, "mock: %s read with nothing queued\n", what);
+        exit(2);
+    }
+    val = q.front();
+    q.pop_front();
+    return val;
+}
+
+void mock_wire_push(uint8_t val){ wire_queue.push_back(val); }
+int TwoWire::read(void){ return mock_pop(wire_queue, "Wire"); }
+
+void mock_pin_push(uint8_t val){ pin_queue.push_back(val); }
+int digitalRead(uint8_t pin){ (void)pin; return mock_pop(pin_queue, "pin"); }
+
+void delay(unsigned long ms){ (void)ms; }
+void pinMode(uint8_t pin, uint8_t mode){ (void)pin; (void)mode; }
+void digitalWrite(uint8_t pin, uint8_t val){ (void)pin; (void)val; }
+void shiftOut(uint8_t data_pin, uint8_t clock_pin, uint8_t order, uint8_t val){
+    (void)data_pin; (void)clock_pin; (void)order; (void)val;
+}
@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+#
+# Decode the binary log records of src/log.h out of the serial stream.
+#
+# Text printed by the firmware is passed through as is. Each record
+# (sync byte, event, ms u32, arg u16, XOR check) is printed as
+#
+#   [ms] event text (arg)
+#
+# Event texts, and whether the arg is signed, are read from the
+# LOG_EVENTS list of src/log.h, so the decoder and the firmware can't
+# drift apart.
+#
+# Usage:
+#   log_decode.py /dev/ttyUSB0 [baud]       Read a serial port (pyserial)
+#   log_decode.py capture.bin               Read a capture file
+#   log_decode.py - < capture.bin           Read stdin
+#
+
+import os
+import re
+import struct
+import sys
+
+SYNC = 0x1E
+RECORD_LEN = 9
+
+HEADER = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                      "..", "..", "src", "log.h")
+
+
+def load_events(path):
+    with open(path) as f:
+        src = f.read()
+    # (text, struct format of the arg) per event
+    return [(text, "<h" if kind == "s16" else "<H")
+            for kind, text in re.findall(
+                r'X\(\s*\w+\s*,\s*([us]16)\s*,\s*"([^"]*)"\s*\)', src)]
+
+
+def decode(stream, events, out):
+    buf = bytearray()
+
+    while True:
+        chunk = stream.read(1)
+        if not chunk:
+            break
+        buf += chunk
+
+        while buf:
+            if buf[0] != SYNC:
+                out.write(chr(buf.pop(0)))
+                continue
+            if len(buf) < RECORD_LEN:
+                break
+
+            rec = buf[:RECORD_LEN]
+            check = 0
+            for b in rec[1:RECORD_LEN - 1]:
+                check ^= b
+            if check != rec[RECORD_LEN - 1]:
+                # Not a record after all, show the byte as text
+                out.write(chr(buf.pop(0)))
+                continue
+
+            event, ms = struct.unpack("<BI", bytes(rec[1:6]))
+            text, fmt = events[event] if event < len(events) else \
+                ("Unknown event %d" % event, "<H")
+            arg, = struct.unpack(fmt, bytes(rec[6:8]))
+            out.write("[%d] %s (%d)\n" % (ms, text, arg))
+            del buf[:RECORD_LEN]
+        out.flush()
+
+
+def main():
+    if len(sys.argv) < 2:
+        sys.exit("Usage: log_decode.py <port|file|-> [baud]")
+
+    events = load_events(HEADER)
+    src = sys.argv[1]
+
+    if src == "-":
+        stream = sys.stdin.buffer
+    elif src.startswith("/dev/") or src.upper().startswith("COM"):
+        import serial
+        baud = int(sys.argv[2]) if len(sys.argv) > 2 else 9600
+        stream = serial.Serial(src, baud)
+    else:
+        stream = open(src, "rb")
+
+    try:
+        decode(stream, events, sys.stdout)
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
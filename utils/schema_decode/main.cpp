@@ -0,0 +1,186 @@
+/*******************************
+ *
+ * File: main.cpp
+ *
+ * schema_decode: turn XBee payloads into CSV.
+ *
+ * Reads one payload per line as hex on stdin (spaces allowed,
+ * lines starting with # are skipped). A payload holds one or more
+ * packets back to back, each starting with its schema number, or
+ * one delta coded batch. Packets are collected per schema and
+ * decoded in batches; every output line is the schema name
+ * followed by the field values and epoch_ms, the Unix time in ms
+ * of the sample (0 if not known, only delta coded batches of a
+ * synced node carry it), after a "# name,field,...,epoch_ms"
+ * header the first time a schema shows up. Batches are flushed in order
+ * of schema, not of arrival.
+ *
+ ******************************/
+
+#include "schema_decode.h"
+#include "schema.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#define BATCH_MAX 4096
+
+struct batch{
+    const struct schema_desc* d;
+    std::vector<uint8_t> data;
+    std::vector<uint64_t> epoch_ms;
+    size_t n;
+    bool header_done;
+};
+
+static std::vector<struct batch> batches;
+static unsigned long unknown = 0;
+static unsigned long truncated = 0;
+
+static void print_header(const struct schema_desc* d){
+    printf("# %s", d->name);
+    for(uint8_t j = 0; j < d->nfields; j++){
+        const struct schema_field* f = &d->fields[j];
+
+        for(uint8_t k = 0; k < f->count; k++){
+            if(f->count > 1){
+                printf(",%s_%u", f->name, k);
+            }
+            else{
+                printf(",%s", f->name);
+            }
+        }
+    }
+    printf(",epoch_ms\n");
+}
+
+static void flush(struct batch* b){
+    std::vector<std::vector<int64_t> > cols(b->d->ncols, std::vector<int64_t>(b->n));
+    std::vector<int64_t*> ptrs(b->d->ncols);
+
+    if(b->n == 0){
+        return;
+    }
+    if(!b->header_done){
+        print_header(b->d);
+        b->header_done = true;
+    }
+
+    for(size_t c = 0; c < ptrs.size(); c++){
+        ptrs[c] = cols[c].data();
+    }
+    schema_decode_batch(b->d, b->data.data(), b->n, ptrs.data());
+
+    for(size_t i = 0; i < b->n; i++){
+        fputs(b->d->name, stdout);
+        for(size_t c = 0; c < ptrs.size(); c++){
+            printf(",%lld", (long long)cols[c][i]);
+        }
+        printf(",%llu\n", (unsigned long long)b->epoch_ms[i]);
+    }
+    b->data.clear();
+    b->epoch_ms.clear();
+    b->n = 0;
+}
+
+static void add_packet(const struct schema_desc* d, const uint8_t* p, uint64_t epoch_ms){
+    struct batch* b = &batches[d - schema_at(0)];
+
+    b->data.insert(b->data.end(), p, p + d->len);
+    b->epoch_ms.push_back(epoch_ms);
+    if(++b->n >= BATCH_MAX){
+        flush(b);
+    }
+}
+
+static void add_payload(const uint8_t* p, size_t len){
+    static uint8_t expanded[255 * 255];
+    static uint64_t epoch_ms[255 * 255];
+
+    // A delta coded batch fills the whole payload. Schemas like
+    // prof_diag have the bit set in their own number.
+    if(len >= 2 && (p[1] & (_SCHEMA_DELTA_ >> 8)) && schema_find(p[0] | p[1] << 8, len) == NULL){
+        const struct schema_desc* d;
+        size_t n = schema_delta_expand(p, len, expanded, sizeof(expanded), &d, epoch_ms);
+
+        if(n == 0){
+            truncated++;
+        }
+        for(size_t i = 0; i < n; i++){
+            add_packet(d, expanded + i * d->len, epoch_ms[i]);
+        }
+        return;
+    }
+
+    while(len >= 2){
+        uint16_t number = p[0] | p[1] << 8;
+        const struct schema_desc* d = schema_find(number, len);
+
+        if(d == NULL){
+            unknown++;
+            return;
+        }
+        if(len < d->len){
+            truncated++;
+            return;
+        }
+        add_packet(d, p, 0);
+        p += d->len;
+        len -= d->len;
+    }
+}
+
+static int hex_val(int c){
+    if(c >= '0' && c <= '9') return c - '0';
+    c = tolower(c);
+    if(c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+int main(void){
+    char line[1024];
+    std::vector<uint8_t> payload;
+
+    batches.resize(schema_count());
+    for(size_t i = 0; i < schema_count(); i++){
+        batches[i].d = schema_at(i);
+        batches[i].n = 0;
+        batches[i].header_done = false;
+    }
+
+    while(fgets(line, sizeof(line), stdin)){
+        int hi = -1;
+
+        if(line[0] == '#'){
+            continue;
+        }
+        payload.clear();
+        for(char* s = line; *s; s++){
+            int v = hex_val(*s);
+
+            if(v < 0){
+                continue;
+            }
+            if(hi < 0){
+                hi = v;
+            }
+            else{
+                payload.push_back(hi << 4 | v);
+                hi = -1;
+            }
+        }
+        add_payload(payload.data(), payload.size());
+    }
+
+    for(size_t i = 0; i < batches.size(); i++){
+        flush(&batches[i]);
+    }
+    if(unknown || truncated){
+        fprintf(stderr, "schema_decode: %lu unknown schema, %lu truncated or malformed payloads\n",
+                unknown, truncated);
+    }
+    return 0;
+}
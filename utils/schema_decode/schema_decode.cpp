@@ -0,0 +1,357 @@
+/*******************************
+ *
+ * File: schema_decode.cpp
+ *
+ * Decoder tables and batch kernels. See schema_decode.h.
+ *
+ ******************************/
+
+#include "schema_decode.h"
+#include "schema.h"
+#include <string.h>
+
+// One field table per schema, offsets are filled in below
+#define DECODE_F(type, name) {#name, SCHEMA_T_##type, 1, 0},
+#define DECODE_A(type, name, count) {#name, SCHEMA_T_##type, count, 0},
+#define DECODE_FIELDS(sname, number, fields) \
+    static struct schema_field sname##_fields[] = { fields(DECODE_F, DECODE_A) };
+SCHEMA_LIST(DECODE_FIELDS)
+
+#define DECODE_DESC(sname, number, fields) \
+    {#sname, number, SCHEMA_LEN(fields), \
+     sizeof(sname##_fields) / sizeof(sname##_fields[0]), 0, sname##_fields},
+static struct schema_desc descs[] = {
+    SCHEMA_LIST(DECODE_DESC)
+};
+
+#define NDESCS (sizeof(descs) / sizeof(descs[0]))
+
+static uint8_t schema_type_size(uint8_t type){
+    switch(type){
+    case SCHEMA_T_u8:
+        return 1;
+    case SCHEMA_T_u16:
+    case SCHEMA_T_i16:
+        return 2;
+    default:
+        return 4;
+    }
+}
+
+/******************************
+ *
+ * Name:        schema_layout
+ * Returns:     Nothing
+ * Parameter:   Nothing
+ * Description: Fill in the field offsets and column counts. Runs
+ *              once before main().
+ *
+ ******************************/
+static struct schema_layout{
+    schema_layout(){
+        for(size_t i = 0; i < NDESCS; i++){
+            struct schema_desc* d = &descs[i];
+            struct schema_field* f = (struct schema_field*)d->fields;
+            uint8_t offset = 0;
+
+            d->ncols = 0;
+            for(uint8_t j = 0; j < d->nfields; j++){
+                f[j].offset = offset;
+                offset += f[j].count * schema_type_size(f[j].type);
+                d->ncols += f[j].count;
+            }
+        }
+    }
+} layout;
+
+/******************************
+ *
+ * Name:        schema_find
+ * Returns:     Schema with the given number, NULL if unknown
+ * Parameter:   Schema number, the first u16 of a packet, bytes
+ *              left in the payload (0 if not known)
+ * Description: Look a schema up by number. Old firmware reused
+ *              some numbers; of the layouts sharing a number,
+ *              the one whose length divides what is left wins,
+ *              then the first one that fits.
+ *
+ ******************************/
+const struct schema_desc* schema_find(uint16_t number, size_t len){
+    const struct schema_desc* fit = NULL;
+    const struct schema_desc* first = NULL;
+
+    for(size_t i = 0; i < NDESCS; i++){
+        const struct schema_desc* d = &descs[i];
+
+        if(d->number != number){
+            continue;
+        }
+        if(len == 0 || len % d->len == 0){
+            return d;
+        }
+        if(fit == NULL && d->len <= len){
+            fit = d;
+        }
+        if(first == NULL){
+            first = d;
+        }
+    }
+    return fit ? fit : first;
+}
+
+size_t schema_count(void){
+    return NDESCS;
+}
+
+const struct schema_desc* schema_at(size_t i){
+    return i < NDESCS ? &descs[i] : NULL;
+}
+
+// Fixed width column kernels, little-endian loads. The packet
+// length is a template parameter, a constant stride is what lets
+// the compiler vectorize the loads.
+template <size_t S>
+static void decode_u8(const uint8_t* __restrict p, size_t n, int64_t* __restrict out){
+    for(size_t i = 0; i < n; i++){
+        out[i] = p[i * S];
+    }
+}
+
+template <size_t S>
+static void decode_u16(const uint8_t* __restrict p, size_t n, int64_t* __restrict out){
+    for(size_t i = 0; i < n; i++){
+        const uint8_t* q = p + i * S;
+        out[i] = (uint16_t)(q[0] | q[1] << 8);
+    }
+}
+
+template <size_t S>
+static void decode_i16(const uint8_t* __restrict p, size_t n, int64_t* __restrict out){
+    for(size_t i = 0; i < n; i++){
+        const uint8_t* q = p + i * S;
+        out[i] = (int16_t)(uint16_t)(q[0] | q[1] << 8);
+    }
+}
+
+template <size_t S>
+static void decode_u32(const uint8_t* __restrict p, size_t n, int64_t* __restrict out){
+    for(size_t i = 0; i < n; i++){
+        const uint8_t* q = p + i * S;
+        out[i] = (uint32_t)q[0] | (uint32_t)q[1] << 8 |
+                 (uint32_t)q[2] << 16 | (uint32_t)q[3] << 24;
+    }
+}
+
+/******************************
+ *
+ * Name:        decode_columns
+ * Returns:     Nothing
+ * Parameter:   Schema, first packet, number of packets, output
+ *              columns
+ * Description: Walk the field table of a schema of length S.
+ *              The loop runs column by column, so every inner
+ *              loop is one load width at one constant stride.
+ *
+ ******************************/
+template <size_t S>
+static void decode_columns(const struct schema_desc* d, const uint8_t* data,
+                           size_t n, int64_t* const* cols){
+    size_t c = 0;
+
+    for(uint8_t j = 0; j < d->nfields; j++){
+        const struct schema_field* f = &d->fields[j];
+        uint8_t size = schema_type_size(f->type);
+
+        for(uint8_t k = 0; k < f->count; k++, c++){
+            const uint8_t* p = data + f->offset + k * size;
+
+            switch(f->type){
+            case SCHEMA_T_u8:
+                decode_u8<S>(p, n, cols[c]);
+                break;
+            case SCHEMA_T_u16:
+                decode_u16<S>(p, n, cols[c]);
+                break;
+            case SCHEMA_T_i16:
+                decode_i16<S>(p, n, cols[c]);
+                break;
+            default:
+                decode_u32<S>(p, n, cols[c]);
+                break;
+            }
+        }
+    }
+}
+
+typedef void (*decode_fn)(const struct schema_desc*, const uint8_t*, size_t, int64_t* const*);
+
+// One instance per schema, in the order of descs
+#define DECODE_FN(sname, number, fields) decode_columns<SCHEMA_LEN(fields)>,
+static const decode_fn decode_fns[] = {
+    SCHEMA_LIST(DECODE_FN)
+};
+
+/******************************
+ *
+ * Name:        schema_decode_batch
+ * Returns:     Nothing
+ * Parameter:   Schema, d->len byte packets laid out back to back,
+ *              number of packets, d->ncols output columns of n
+ *              values each
+ * Description: Decode a batch of packets of one schema
+ *
+ ******************************/
+void schema_decode_batch(const struct schema_desc* d, const uint8_t* data,
+                         size_t n, int64_t* const* cols){
+    decode_fns[d - descs](d, data, n, cols);
+}
+
+// Packet header, for delta batches
+static const struct schema_field header_fields[] = {
+    SCHEMA_PACKET_HEADER(DECODE_F, DECODE_A)
+};
+static const uint8_t header_n = SCHEMA_COUNT(SCHEMA_PACKET_HEADER);
+
+#define _DECODE_UPTIME_ 2
+#define _DECODE_OVERFLOW_ 3
+
+static uint8_t read_varint(const uint8_t** p, const uint8_t* end, uint32_t* v){
+    uint8_t shift = 0;
+
+    *v = 0;
+    while(*p < end && shift < 35){
+        uint8_t b = *(*p)++;
+
+        *v |= (uint32_t)(b & 0x7F) << shift;
+        if(!(b & 0x80)){
+            return 1;
+        }
+        shift += 7;
+    }
+    return 0;
+}
+
+static int32_t unzigzag(uint32_t v){
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+static uint32_t load_le(const uint8_t* p, uint8_t size){
+    uint32_t v = 0;
+
+    for(uint8_t i = 0; i < size; i++){
+        v |= (uint32_t)p[i] << (8 * i);
+    }
+    return v;
+}
+
+static void store_le(uint8_t* p, uint8_t size, uint32_t v){
+    for(uint8_t i = 0; i < size; i++){
+        p[i] = v >> (8 * i);
+    }
+}
+
+// Node uptime of a packet, overflow_num:uptime_ms
+static uint64_t local_ms(const uint8_t* p, const struct schema_desc* d){
+    return (uint64_t)p[d->fields[_DECODE_OVERFLOW_].offset] << 32 |
+           load_le(p + d->fields[_DECODE_UPTIME_].offset, 4);
+}
+
+/******************************
+ *
+ * Name:        schema_delta_expand
+ * Returns:     Number of packets written to out, 0 if the payload
+ *              is not a well formed delta batch
+ * Parameter:   Payload, its length, output buffer and its size,
+ *              schema of the packets written, Unix time in ms of
+ *              each packet (out_size / len entries, 0 if the node
+ *              was not synced)
+ * Description: Turn a delta coded batch back into full packets
+ *              of (*d_out)->len bytes each, laid out back to
+ *              back for schema_decode_batch()
+ *
+ ******************************/
+size_t schema_delta_expand(const uint8_t* p, size_t len, uint8_t* out, size_t out_size,
+                           const struct schema_desc** d_out, uint64_t* epoch_ms){
+    const uint8_t* end = p + len;
+    const struct schema_desc* d;
+    uint16_t number;
+    uint8_t n;
+    int32_t step = 0;
+    uint64_t epoch;
+    uint32_t v;
+    int32_t drift_ppm;
+
+    if(len < 9){
+        return 0;
+    }
+    number = p[0] | p[1] << 8;
+    if(!(number & _SCHEMA_DELTA_)){
+        return 0;
+    }
+    d = schema_find(number & ~_SCHEMA_DELTA_, 0);
+    n = p[2];
+    epoch = (uint64_t)load_le(p + 3, 4) * 1000 + load_le(p + 7, 2);
+    p += 9;
+    if(!read_varint(&p, end, &v)){
+        return 0;
+    }
+    drift_ppm = unzigzag(v);
+
+    // Only schemas that start with the current packet header
+    if(d == NULL || n == 0 || d->nfields < header_n || (size_t)(end - p) < d->len ||
+       (size_t)n * d->len > out_size){
+        return 0;
+    }
+    for(uint8_t j = 0; j < d->nfields; j++){
+        if(j < header_n ? strcmp(d->fields[j].name, header_fields[j].name) != 0 :
+                          d->fields[j].count != 1){
+            return 0;
+        }
+    }
+
+    memcpy(out, p, d->len);
+    p += d->len;
+    epoch_ms[0] = epoch;
+
+    for(uint8_t i = 1; i < n; i++){
+        const uint8_t* prev = out + (i - 1) * d->len;
+        uint8_t* cur = out + i * d->len;
+        const struct schema_field* up = &d->fields[_DECODE_UPTIME_];
+        const struct schema_field* ov = &d->fields[_DECODE_OVERFLOW_];
+        uint32_t prev_up = load_le(prev + up->offset, 4);
+
+        memcpy(cur, prev, d->len);
+
+        if(!read_varint(&p, end, &v)){
+            return 0;
+        }
+        step += unzigzag(v);
+        store_le(cur + up->offset, 4, prev_up + step);
+        if(prev_up + step < prev_up){
+            cur[ov->offset]++;
+        }
+
+        for(uint8_t j = header_n; j < d->nfields; j++){
+            const struct schema_field* f = &d->fields[j];
+            uint8_t size = schema_type_size(f->type);
+
+            if(!read_varint(&p, end, &v)){
+                return 0;
+            }
+            store_le(cur + f->offset, size, load_le(prev + f->offset, size) + unzigzag(v));
+        }
+
+        // Uptime since the first sample, corrected for the drift
+        if(epoch){
+            int64_t t = (int64_t)(local_ms(cur, d) - local_ms(out, d));
+
+            epoch_ms[i] = epoch + t + t * drift_ppm / 1000000;
+        }
+        else{
+            epoch_ms[i] = 0;
+        }
+    }
+
+    *d_out = d;
+    return n;
+}
@@ -0,0 +1,58 @@
+/*******************************
+ *
+ * File: schema_decode.h
+ *
+ * Table-driven host decoder for the packet schemas of
+ * src/schema.h. The tables are generated from the same field
+ * lists the firmware encodes with, so a layout change on the
+ * node is picked up by rebuilding this decoder.
+ *
+ * Packets of one schema are decoded a batch at a time into
+ * columns, one int64_t array per field element. Each column is a
+ * fixed width loop at a compile-time stride (one instance per
+ * schema), which the compiler can vectorize.
+ *
+ * Delta coded batches (SCHEMA_DELTA in schema.h) are expanded back
+ * into full packets first with schema_delta_expand(), which also
+ * gives the Unix time of each packet.
+ *
+ ******************************/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef SCHEMA_DECODE_H
+#define SCHEMA_DECODE_H
+
+enum schema_type{
+    SCHEMA_T_u8,
+    SCHEMA_T_u16,
+    SCHEMA_T_i16,
+    SCHEMA_T_u32,
+};
+
+struct schema_field{
+    const char* name;
+    uint8_t type;
+    uint8_t count;          // 1 for a scalar
+    uint8_t offset;         // Wire offset of element 0
+};
+
+struct schema_desc{
+    const char* name;
+    uint16_t number;
+    uint8_t len;            // Wire length of one packet
+    uint8_t nfields;
+    uint8_t ncols;          // Field elements, arrays expanded
+    const struct schema_field* fields;
+};
+
+const struct schema_desc* schema_find(uint16_t number, size_t len);
+size_t schema_count(void);
+const struct schema_desc* schema_at(size_t i);
+
+void schema_decode_batch(const struct schema_desc* d, const uint8_t* data,
+                         size_t n, int64_t* const* cols);
+size_t schema_delta_expand(const uint8_t* p, size_t len, uint8_t* out, size_t out_size,
+                           const struct schema_desc** d_out, uint64_t* epoch_ms);
+#endif